@@ -25,6 +25,7 @@
 #include <KLocalizedString>
 
 #include <model/multi_dock_model.h>
+#include <utils/icon_cache.h>
 #include <view/multi_dock_view.h>
 
 int main(int argc, char** argv) {
@@ -43,7 +44,9 @@ int main(int argc, char** argv) {
   KAboutData::setApplicationData(about);
   QApplication::setWindowIcon(QIcon::fromTheme("user-desktop"));
 
-  ksmoothdock::MultiDockModel model(QDir::homePath() + "/.ksmoothdock");
+  const QString configDir = QDir::homePath() + "/.ksmoothdock";
+  ksmoothdock::IconCache::global()->setDiskCacheDir(configDir + "/cache");
+  ksmoothdock::MultiDockModel model(configDir);
   ksmoothdock::MultiDockView view(&model);
   view.show();
   return app.exec();
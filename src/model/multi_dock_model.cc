@@ -38,13 +38,18 @@ constexpr char MultiDockModel::kShowPager[];
 constexpr char MultiDockModel::kShowTaskManager[];
 constexpr char MultiDockModel::kVisibility[];
 
+constexpr char MultiDockModel::kAnimationCurve[];
+constexpr char MultiDockModel::kAnimationDuration[];
 constexpr char MultiDockModel::kBackgroundColor[];
 constexpr char MultiDockModel::kBorderColor[];
+constexpr char MultiDockModel::kFixedSizeWindow[];
 constexpr char MultiDockModel::kMaximumIconSize[];
 constexpr char MultiDockModel::kMinimumIconSize[];
 constexpr char MultiDockModel::kSpacingFactor[];
 constexpr char MultiDockModel::kShowBorder[];
 constexpr char MultiDockModel::kTooltipFontSize[];
+constexpr char MultiDockModel::kZoomCurve[];
+constexpr char MultiDockModel::kZoomUpdateRate[];
 constexpr char MultiDockModel::kApplicationMenuCategory[];
 constexpr char MultiDockModel::kIcon[];
 constexpr char MultiDockModel::kLabel[];
@@ -48,9 +48,20 @@ enum class PanelPosition { Top, Bottom, Left, Right };
 enum class PanelVisibility { AlwaysVisible, AutoHide, WindowsCanCover,
                              WindowsGoBelow, WindowsCanCover_Quiet };
 
+// The shape of the zoom curve, i.e. icon size vs. distance to the mouse.
+enum class ZoomCurve { Parabolic, Cosine, Gaussian };
+
+// The easing curve of the zoom-in/zoom-out animation.
+enum class AnimationCurve { Linear, OutQuad, InOutQuad, OutCubic };
+
 constexpr int kDefaultMinSize = 48;
 constexpr int kDefaultMaxSize = 128;
 constexpr float kDefaultSpacingFactor = 0.5;
+constexpr ZoomCurve kDefaultZoomCurve = ZoomCurve::Parabolic;
+constexpr int kDefaultZoomUpdateRate = 60;
+constexpr int kDefaultAnimationDuration = 320;  // in milliseconds.
+constexpr AnimationCurve kDefaultAnimationCurve = AnimationCurve::Linear;
+constexpr bool kDefaultFixedSizeWindow = false;
 constexpr int kDefaultTooltipFontSize = 20;
 constexpr float kDefaultBackgroundAlpha = 0.42;
 constexpr char kDefaultBackgroundColor[] = "#638abd";
@@ -148,6 +159,57 @@ class MultiDockModel : public QObject {
     setAppearanceProperty(kGeneralCategory, kSpacingFactor, value);
   }
 
+  ZoomCurve zoomCurve() const {
+    return static_cast<ZoomCurve>(appearanceProperty(
+        kGeneralCategory, kZoomCurve, static_cast<int>(kDefaultZoomCurve)));
+  }
+
+  void setZoomCurve(ZoomCurve value) {
+    setAppearanceProperty(kGeneralCategory, kZoomCurve,
+                          static_cast<int>(value));
+  }
+
+  // Max number of times per second the zoom is updated when the mouse moves.
+  int zoomUpdateRate() const {
+    return appearanceProperty(kGeneralCategory, kZoomUpdateRate,
+                              kDefaultZoomUpdateRate);
+  }
+
+  void setZoomUpdateRate(int value) {
+    setAppearanceProperty(kGeneralCategory, kZoomUpdateRate, value);
+  }
+
+  int animationDuration() const {
+    return appearanceProperty(kGeneralCategory, kAnimationDuration,
+                              kDefaultAnimationDuration);
+  }
+
+  void setAnimationDuration(int value) {
+    setAppearanceProperty(kGeneralCategory, kAnimationDuration, value);
+  }
+
+  AnimationCurve animationCurve() const {
+    return static_cast<AnimationCurve>(appearanceProperty(
+        kGeneralCategory, kAnimationCurve,
+        static_cast<int>(kDefaultAnimationCurve)));
+  }
+
+  void setAnimationCurve(AnimationCurve value) {
+    setAppearanceProperty(kGeneralCategory, kAnimationCurve,
+                          static_cast<int>(value));
+  }
+
+  // Whether the dock windows keep their zoomed size, using a window mask for
+  // the minimized state instead of being resized on zooming in and out.
+  bool fixedSizeWindow() const {
+    return appearanceProperty(kGeneralCategory, kFixedSizeWindow,
+                              kDefaultFixedSizeWindow);
+  }
+
+  void setFixedSizeWindow(bool value) {
+    setAppearanceProperty(kGeneralCategory, kFixedSizeWindow, value);
+  }
+
   QColor backgroundColor() const {
     QColor defaultBackgroundColor(kDefaultBackgroundColor);
     defaultBackgroundColor.setAlphaF(kDefaultBackgroundAlpha);
@@ -448,13 +510,18 @@ class MultiDockModel : public QObject {
   // Global appearance config's categories/properties.
 
   // General category.
+  static constexpr char kAnimationCurve[] = "animationCurve";
+  static constexpr char kAnimationDuration[] = "animationDuration";
   static constexpr char kBackgroundColor[] = "backgroundColor";
   static constexpr char kBorderColor[] = "borderColor";
+  static constexpr char kFixedSizeWindow[] = "fixedSizeWindow";
   static constexpr char kMaximumIconSize[] = "maximumIconSize";
   static constexpr char kMinimumIconSize[] = "minimumIconSize";
   static constexpr char kSpacingFactor[] = "spacingFactor";
   static constexpr char kShowBorder[] = "showBorder";
   static constexpr char kTooltipFontSize[] = "tooltipFontSize";
+  static constexpr char kZoomCurve[] = "zoomCurve";
+  static constexpr char kZoomUpdateRate[] = "zoomUpdateRate";
 
   static constexpr char kApplicationMenuCategory[] = "Application Menu";
   static constexpr char kIcon[] = "icon";
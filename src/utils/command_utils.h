@@ -20,6 +20,7 @@
 #define KSMOOTHDOCK_COMMAND_UTILS_H_
 
 #include <filesystem>
+#include <vector>
 
 #include <QString>
 
@@ -60,10 +61,36 @@ inline QString getTaskCommand(const QString& appCommand) {
   return QString::fromStdString(getTaskCommand(appCommand.toStdString()));
 }
 
-inline bool areTheSameCommand(const QString& appTaskCommand, const QString& taskCommand) {
+// A task command that is different from the task command of its application.
+struct TaskCommandAlias {
+  const char* taskCommand;
+  const char* appTaskCommand;
+};
+
+static constexpr TaskCommandAlias kTaskCommandAliases[] = {
   // Fix for System Settings.
-  if (taskCommand == "systemsettings" && appTaskCommand == "systemsettings5") {
-    return true;
+  {"systemsettings", "systemsettings5"},
+};
+
+// Gets the task commands that belong to an application, i.e. its own task
+// command and its aliases.
+inline std::vector<QString> getTaskCommandAliases(
+    const QString& appTaskCommand) {
+  std::vector<QString> taskCommands = {appTaskCommand};
+  for (const auto& alias : kTaskCommandAliases) {
+    if (appTaskCommand == alias.appTaskCommand) {
+      taskCommands.push_back(alias.taskCommand);
+    }
+  }
+  return taskCommands;
+}
+
+inline bool areTheSameCommand(const QString& appTaskCommand, const QString& taskCommand) {
+  for (const auto& alias : kTaskCommandAliases) {
+    if (taskCommand == alias.taskCommand &&
+        appTaskCommand == alias.appTaskCommand) {
+      return true;
+    }
   }
   return appTaskCommand == taskCommand;
 }
@@ -0,0 +1,175 @@
+/*
+ * This file is part of KSmoothDock.
+ * Copyright (C) 2018 Viet Dang (dangvd@gmail.com)
+ *
+ * KSmoothDock is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * KSmoothDock is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with KSmoothDock.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "draw_utils.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <QCache>
+#include <QHash>
+#include <QImage>
+
+namespace ksmoothdock {
+
+namespace {
+
+// The memory budget of the bordered text cache, in kilobytes.
+constexpr int kBorderedTextCacheMaxCost = 4 * 1024;
+
+QCache<QString, QPixmap>& borderedTextCache() {
+  static QCache<QString, QPixmap> cache(kBorderedTextCacheMaxCost);
+  return cache;
+}
+
+QHash<QString, QPixmap>& roundedRectPatches() {
+  static QHash<QString, QPixmap> patches;
+  return patches;
+}
+
+// Sets each value to the max value in the (2 * radius + 1) square around it,
+// as a horizontal then a vertical pass. The radius is a border width of a few
+// pixels so each pass simply scans the window.
+std::vector<int> dilate(const std::vector<int>& values, int width, int height,
+                        int radius) {
+  std::vector<int> rows(values.size());
+  for (int y = 0; y < height; ++y) {
+    for (int x = 0; x < width; ++x) {
+      int value = 0;
+      const int last = std::min(x + radius, width - 1);
+      for (int k = std::max(x - radius, 0); k <= last; ++k) {
+        value = std::max(value, values[y * width + k]);
+      }
+      rows[y * width + x] = value;
+    }
+  }
+
+  std::vector<int> result(values.size());
+  for (int y = 0; y < height; ++y) {
+    const int last = std::min(y + radius, height - 1);
+    for (int x = 0; x < width; ++x) {
+      int value = 0;
+      for (int k = std::max(y - radius, 0); k <= last; ++k) {
+        value = std::max(value, rows[k * width + x]);
+      }
+      result[y * width + x] = value;
+    }
+  }
+  return result;
+}
+
+// Creates a transparent image of the given logical size.
+QImage createImage(int width, int height, qreal devicePixelRatio) {
+  QImage image(static_cast<int>(std::ceil(width * devicePixelRatio)),
+               static_cast<int>(std::ceil(height * devicePixelRatio)),
+               QImage::Format_ARGB32_Premultiplied);
+  image.setDevicePixelRatio(devicePixelRatio);
+  image.fill(Qt::transparent);
+  return image;
+}
+
+void drawText(QImage* image, int x, int y, int width, int height, int flags,
+              const QString& text, const QFont& font, QColor color) {
+  QPainter painter(image);
+  painter.setRenderHint(QPainter::TextAntialiasing);
+  painter.setFont(font);
+  painter.setPen(color);
+  painter.drawText(x, y, width, height, flags, text);
+}
+
+}  // namespace
+
+QPixmap getBorderedText(int width, int height, int flags, const QString& text,
+                        const QFont& font, int borderWidth,
+                        QColor borderColor, QColor textColor,
+                        qreal devicePixelRatio) {
+  const QString key = text + QLatin1Char('\n') + font.key()
+      + QString("\n%1x%2@%3/%4/%5/%6/%7")
+          .arg(width).arg(height).arg(devicePixelRatio).arg(flags)
+          .arg(borderWidth).arg(borderColor.rgba()).arg(textColor.rgba());
+  auto& cache = borderedTextCache();
+  if (const QPixmap* pixmap = cache.object(key)) {
+    return *pixmap;
+  }
+
+  const int spriteWidth = width + 2 * borderWidth;
+  const int spriteHeight = height + 2 * borderWidth;
+  // The text's alpha mask.
+  QImage mask = createImage(spriteWidth, spriteHeight, devicePixelRatio);
+  drawText(&mask, borderWidth, borderWidth, width, height, flags, text, font,
+           Qt::white);
+  const int w = mask.width();
+  const int h = mask.height();
+  std::vector<int> alpha(w * h);
+  for (int y = 0; y < h; ++y) {
+    const QRgb* line = reinterpret_cast<const QRgb*>(mask.constScanLine(y));
+    for (int x = 0; x < w; ++x) {
+      alpha[y * w + x] = qAlpha(line[x]);
+    }
+  }
+  const int radius =
+      static_cast<int>(std::lround(borderWidth * devicePixelRatio));
+  const std::vector<int> border = dilate(alpha, w, h, radius);
+
+  // The border is filled in the border color, then the text is drawn on top.
+  QImage image = createImage(spriteWidth, spriteHeight, devicePixelRatio);
+  const QRgb borderRgb = borderColor.rgba();
+  for (int y = 0; y < h; ++y) {
+    QRgb* line = reinterpret_cast<QRgb*>(image.scanLine(y));
+    for (int x = 0; x < w; ++x) {
+      line[x] = qPremultiply(qRgba(
+          qRed(borderRgb), qGreen(borderRgb), qBlue(borderRgb),
+          qAlpha(borderRgb) * border[y * w + x] / 255));
+    }
+  }
+  drawText(&image, borderWidth, borderWidth, width, height, flags, text, font,
+           textColor);
+
+  const QPixmap pixmap = QPixmap::fromImage(image);
+  cache.insert(key, new QPixmap(pixmap), std::max(w * h * 4 / 1024, 1));
+  return pixmap;
+}
+
+QPixmap getRoundedRectPatch(QColor color, int radius,
+                            qreal devicePixelRatio) {
+  const QString key = QString("%1/%2@%3").arg(color.rgba()).arg(radius)
+      .arg(devicePixelRatio);
+  auto& patches = roundedRectPatches();
+  const auto it = patches.constFind(key);
+  if (it != patches.constEnd()) {
+    return it.value();
+  }
+
+  // The corners, plus one pixel that is stretched for the edges and the
+  // center.
+  const int size = 2 * (radius + 1) + 1;
+  QImage image = createImage(size, size, devicePixelRatio);
+  {
+    QPainter painter(&image);
+    painter.setRenderHint(QPainter::Antialiasing);
+    QPainterPath path;
+    path.addRoundedRect(QRect(0, 0, size, size), radius, radius);
+    painter.fillPath(path, QBrush(color));
+  }
+  const QPixmap pixmap = QPixmap::fromImage(image);
+  patches.insert(key, pixmap);
+  return pixmap;
+}
+
+}  // namespace ksmoothdock
@@ -21,52 +21,78 @@
 
 #include <QBrush>
 #include <QColor>
+#include <QFont>
+#include <QFontMetrics>
+#include <QMargins>
 #include <QPainter>
 #include <QPainterPath>
+#include <QPixmap>
 #include <QRect>
 #include <QString>
+#include <qdrawutil.h>
 
 namespace ksmoothdock {
 
-inline void drawBorderedText(int x, int y, const QString& text, int borderWidth,
-                             QColor borderColor, QColor textColor,
-                             QPainter* painter) {
-  painter->setPen(borderColor);
-  for (int i = -borderWidth; i <= borderWidth; ++i) {
-    for (int j = -borderWidth; j <= borderWidth; ++j) {
-      painter->drawText(x + i, y + j, text);
-    }
-  }
-
-  painter->setPen(textColor);
-  painter->drawText(x, y, text);
-}
+// Gets the text with a border around it, rendered into a pixmap of
+// (width + 2 * borderWidth) x (height + 2 * borderWidth) logical pixels. The
+// text is laid out in the inner rect as by QPainter::drawText() with the
+// given flags, and the border is its alpha mask dilated by borderWidth.
+//
+// The pixmaps are cached by text, font, size, flags, colors and border width
+// so that repainting the same text is a single blit.
+QPixmap getBorderedText(int width, int height, int flags, const QString& text,
+                        const QFont& font, int borderWidth,
+                        QColor borderColor, QColor textColor,
+                        qreal devicePixelRatio);
 
 inline void drawBorderedText(int x, int y, int width, int height, int flags,
                              const QString& text, int borderWidth,
                              QColor borderColor, QColor textColor,
                              QPainter* painter) {
-  painter->setPen(borderColor);
-  for (int i = -borderWidth; i <= borderWidth; ++i) {
-    for (int j = -borderWidth; j <= borderWidth; ++j) {
-      painter->drawText(x + i, y + j, width, height, flags, text);
-    }
-  }
+  painter->drawPixmap(
+      x - borderWidth, y - borderWidth,
+      getBorderedText(width, height, flags, text, painter->font(),
+                      borderWidth, borderColor, textColor,
+                      painter->device()->devicePixelRatioF()));
+}
 
-  painter->setPen(textColor);
-  painter->drawText(x, y, width, height, flags, text);
+// Draws the text with its baseline starting at (x, y).
+inline void drawBorderedText(int x, int y, const QString& text, int borderWidth,
+                             QColor borderColor, QColor textColor,
+                             QPainter* painter) {
+  const QFontMetrics metrics = painter->fontMetrics();
+  drawBorderedText(x, y - metrics.ascent(), metrics.horizontalAdvance(text),
+                   metrics.height(), Qt::AlignLeft | Qt::AlignTop, text,
+                   borderWidth, borderColor, textColor, painter);
 }
 
+// Gets an antialiased rounded rect of the given color and corner radius as a
+// nine-patch pixmap, i.e. to be stretched by qDrawBorderPixmap() with margins
+// of radius + 1. The pixmaps are cached by color, radius and device pixel
+// ratio.
+QPixmap getRoundedRectPatch(QColor color, int radius, qreal devicePixelRatio);
+
 inline void drawHighlightedIcon(QColor bgColor, int left, int top, int width, int height,
                                 int padding, int roundedRectRadius, QPainter* painter,
                                 float alpha = 0.42) {
-  painter->setRenderHint(QPainter::Antialiasing);
   QColor fillColor = bgColor.lighter(500);
   fillColor.setAlphaF(alpha);
+  const QRect rect(left - padding, top - padding, width + 2 * padding,
+                   height + 2 * padding);
+  const int margin = roundedRectRadius + 1;
+  if (roundedRectRadius >= 0 && rect.width() > 2 * margin
+      && rect.height() > 2 * margin) {
+    const qreal devicePixelRatio = painter->device()->devicePixelRatioF();
+    qDrawBorderPixmap(painter, rect, QMargins(margin, margin, margin, margin),
+                      getRoundedRectPatch(fillColor, roundedRectRadius,
+                                          devicePixelRatio));
+    return;
+  }
+
+  // Too small for the nine-patch.
+  painter->setRenderHint(QPainter::Antialiasing);
   QPainterPath path;
-  path.addRoundedRect(
-      QRect(left - padding, top - padding, width + 2 * padding, height + 2 * padding),
-      roundedRectRadius, roundedRectRadius);
+  path.addRoundedRect(rect, roundedRectRadius, roundedRectRadius);
   painter->fillPath(path, QBrush(fillColor));
   painter->setRenderHint(QPainter::Antialiasing, false);
 }
@@ -0,0 +1,119 @@
+/*
+ * This file is part of KSmoothDock.
+ * Copyright (C) 2018 Viet Dang (dangvd@gmail.com)
+ *
+ * KSmoothDock is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * KSmoothDock is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with KSmoothDock.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "draw_utils.h"
+
+#include <cstdlib>
+
+#include <QFont>
+#include <QFontMetrics>
+#include <QImage>
+#include <QPainter>
+#include <QTest>
+
+namespace ksmoothdock {
+
+constexpr int kBorderWidth = 2;
+constexpr int kFlags = Qt::AlignCenter;
+const QColor kBorderColor = Qt::black;
+const QColor kTextColor = Qt::white;
+
+class DrawUtilsTest: public QObject {
+  Q_OBJECT
+
+ private slots:
+  void init() {
+    font_.setPixelSize(24);
+    text_ = "12:34";
+    const QFontMetrics metrics(font_);
+    width_ = metrics.horizontalAdvance(text_) + 4;
+    height_ = metrics.height();
+  }
+
+  // Tests that the bordered text looks like the text drawn at every offset
+  // up to the border width in the border color, then in the text color.
+  void borderedText();
+
+  // Tests that the bordered text is rendered once for the same arguments.
+  void borderedTextCached();
+
+ private:
+  QPixmap getText(const QString& text) {
+    return getBorderedText(width_, height_, kFlags, text, font_, kBorderWidth,
+                           kBorderColor, kTextColor, 1.0);
+  }
+
+  // Draws the bordered text as it was drawn before it was cached.
+  QImage drawTextAtOffsets() {
+    QImage image(width_ + 2 * kBorderWidth, height_ + 2 * kBorderWidth,
+                 QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+    QPainter painter(&image);
+    painter.setRenderHint(QPainter::TextAntialiasing);
+    painter.setFont(font_);
+    painter.setPen(kBorderColor);
+    for (int i = -kBorderWidth; i <= kBorderWidth; ++i) {
+      for (int j = -kBorderWidth; j <= kBorderWidth; ++j) {
+        painter.drawText(kBorderWidth + i, kBorderWidth + j, width_, height_,
+                         kFlags, text_);
+      }
+    }
+    painter.setPen(kTextColor);
+    painter.drawText(kBorderWidth, kBorderWidth, width_, height_, kFlags,
+                     text_);
+    return image;
+  }
+
+  QFont font_;
+  QString text_;
+  int width_;
+  int height_;
+};
+
+void DrawUtilsTest::borderedText() {
+  const QImage expected = drawTextAtOffsets();
+  const QImage actual = getText(text_).toImage().convertToFormat(
+      QImage::Format_ARGB32_Premultiplied);
+  QCOMPARE(actual.size(), expected.size());
+
+  // The antialiased edges differ as the border is dilated instead of drawn
+  // over itself, so the images are compared on average.
+  long long difference = 0;
+  for (int y = 0; y < expected.height(); ++y) {
+    for (int x = 0; x < expected.width(); ++x) {
+      const QRgb a = actual.pixel(x, y);
+      const QRgb e = expected.pixel(x, y);
+      difference += std::abs(qRed(a) - qRed(e))
+          + std::abs(qGreen(a) - qGreen(e)) + std::abs(qBlue(a) - qBlue(e))
+          + std::abs(qAlpha(a) - qAlpha(e));
+    }
+  }
+  const long long channels = 4LL * expected.width() * expected.height();
+  QVERIFY(difference <= 8 * channels);
+}
+
+void DrawUtilsTest::borderedTextCached() {
+  const QPixmap text = getText(text_);
+  QCOMPARE(getText(text_).cacheKey(), text.cacheKey());
+  QVERIFY(getText(text_ + "5").cacheKey() != text.cacheKey());
+}
+
+}  // namespace ksmoothdock
+
+QTEST_MAIN(ksmoothdock::DrawUtilsTest)
+#include "draw_utils_test.moc"
@@ -0,0 +1,70 @@
+/*
+ * This file is part of KSmoothDock.
+ * Copyright (C) 2018 Viet Dang (dangvd@gmail.com)
+ *
+ * KSmoothDock is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * KSmoothDock is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with KSmoothDock.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "font_utils.h"
+
+#include <QHash>
+
+namespace ksmoothdock {
+
+namespace {
+
+// There is an entry per item size and reference string, so the cache stays
+// small. This bounds it anyway.
+constexpr int kMaxFontSizeCacheSize = 1024;
+
+QHash<QString, QFont>& fontSizeCache() {
+  static QHash<QString, QFont> cache;
+  return cache;
+}
+
+}  // namespace
+
+QFont adjustFontSize(int w, int h, const QString& referenceString,
+                     float scaleFactor, const QString& fontFamily) {
+  auto& cache = fontSizeCache();
+  const QString key = QString("%1x%2/%3/%4/").arg(w).arg(h).arg(scaleFactor)
+      .arg(fontFamily) + referenceString;
+  const auto it = cache.constFind(key);
+  if (it != cache.constEnd()) {
+    return it.value();
+  }
+
+  QFont font;
+  QFontMetrics metrics(font);
+  const QRect& rect = metrics.tightBoundingRect(referenceString);
+  // Scale the font size according to the size of the dock.
+  font.setPointSize(std::min(font.pointSize() * w / rect.width(),
+                             font.pointSize() * h / rect.height()));
+  font.setPointSize(static_cast<int>(font.pointSize() * scaleFactor));
+  if (!fontFamily.isEmpty()) {
+    font.setFamily(fontFamily);
+  }
+
+  if (cache.size() >= kMaxFontSizeCacheSize) {
+    cache.clear();
+  }
+  cache.insert(key, font);
+  return font;
+}
+
+void clearFontSizeCache() {
+  fontSizeCache().clear();
+}
+
+}  // namespace ksmoothdock
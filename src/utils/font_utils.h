@@ -32,21 +32,15 @@ namespace ksmoothdock {
 
 // Returns a QFont with font size adjusted automatically according to the given
 // width, height, reference string and scale factor.
-inline QFont adjustFontSize(int w, int h, const QString& referenceString,
-                            float scaleFactor, const QString& fontFamily = "") {
-  QFont font;
-  QFontMetrics metrics(font);
-  const QRect& rect = metrics.tightBoundingRect(referenceString);
-  // Scale the font size according to the size of the dock.
-  font.setPointSize(std::min(font.pointSize() * w / rect.width(),
-                             font.pointSize() * h / rect.height()));
-  font.setPointSize(static_cast<int>(font.pointSize() * scaleFactor));
-  if (!fontFamily.isEmpty()) {
-    font.setFamily(fontFamily);
-  }
+//
+// The fonts are cached by these parameters so that painting at the same size
+// again, e.g. during the zoom, doesn't measure the reference string again.
+QFont adjustFontSize(int w, int h, const QString& referenceString,
+                     float scaleFactor, const QString& fontFamily = "");
 
-  return font;
-}
+// Clears the fonts cached by adjustFontSize(). Should be called when the
+// available fonts, the application font or the appearance config change.
+void clearFontSizeCache();
 
 // Gets the list of base font families, i.e. just 'Noto Sans'
 // instead of 'Noto Sans Bold', 'Noto Sans CJK' etc.
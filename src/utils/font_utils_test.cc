@@ -0,0 +1,77 @@
+/*
+ * This file is part of KSmoothDock.
+ * Copyright (C) 2018 Viet Dang (dangvd@gmail.com)
+ *
+ * KSmoothDock is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * KSmoothDock is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with KSmoothDock.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "font_utils.h"
+
+#include <QFont>
+#include <QGuiApplication>
+#include <QTest>
+
+namespace ksmoothdock {
+
+constexpr int kWidth = 100;
+constexpr int kHeight = 40;
+constexpr float kScaleFactor = 1.0;
+constexpr char kReferenceString[] = "08:08";
+constexpr char kFontFamily[] = "KSmoothDock Test Font";
+
+class FontUtilsTest: public QObject {
+  Q_OBJECT
+
+ private slots:
+  void init() {
+    appFont_ = QGuiApplication::font();
+    clearFontSizeCache();
+  }
+
+  void cleanup() {
+    QGuiApplication::setFont(appFont_);
+    clearFontSizeCache();
+  }
+
+  // Tests that the font is measured once for the same arguments, and again
+  // after the cache has been cleared.
+  void adjustFontSizeCached();
+
+ private:
+  QFont adjustFont() {
+    return adjustFontSize(kWidth, kHeight, kReferenceString, kScaleFactor);
+  }
+
+  QFont appFont_;
+};
+
+void FontUtilsTest::adjustFontSizeCached() {
+  const QFont font = adjustFont();
+  QVERIFY(font.family() != kFontFamily);
+
+  // The font is based on the application font, so it would be of the new
+  // family if it were measured again.
+  QFont appFont = appFont_;
+  appFont.setFamily(kFontFamily);
+  QGuiApplication::setFont(appFont);
+  QCOMPARE(adjustFont(), font);
+
+  clearFontSizeCache();
+  QCOMPARE(adjustFont().family(), QString(kFontFamily));
+}
+
+}  // namespace ksmoothdock
+
+QTEST_MAIN(ksmoothdock::FontUtilsTest)
+#include "font_utils_test.moc"
@@ -0,0 +1,333 @@
+/*
+ * This file is part of KSmoothDock.
+ * Copyright (C) 2018 Viet Dang (dangvd@gmail.com)
+ *
+ * KSmoothDock is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * KSmoothDock is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with KSmoothDock.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "icon_cache.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QGuiApplication>
+#include <QMetaObject>
+#include <QRunnable>
+#include <QSaveFile>
+#include <QVector>
+
+#include <KIconLoader>
+#include <KIconTheme>
+
+namespace ksmoothdock {
+
+namespace {
+
+// Layout of the icon atlas file, in native byte order:
+//
+//   header: magic, version, number of entries, reserved (4 x quint32)
+//   records: key offset, key length, data offset, width, height,
+//       bytes per line, device pixel ratio x 1000 (7 x quint32 each)
+//   keys: UTF-8, not terminated
+//   data: ARGB32 premultiplied images, each aligned to kDataAlignment bytes
+constexpr quint32 kAtlasMagic = 0x4144534b;  // "KSDA"
+constexpr int kHeaderFields = 4;
+constexpr int kRecordFields = 7;
+constexpr qint64 kHeaderSize = kHeaderFields * sizeof(quint32);
+constexpr qint64 kRecordSize = kRecordFields * sizeof(quint32);
+constexpr qint64 kDataAlignment = 16;
+
+qint64 align(qint64 offset) {
+  return (offset + kDataAlignment - 1) / kDataAlignment * kDataAlignment;
+}
+
+// Writes the icon atlas file. Runs on a worker thread, then calls back
+// IconCache::onAtlasSaved() on the cache's thread with the new icons' keys.
+// The cleanup function of the images referring to an atlas file. Releases the
+// image's reference to the file, which can be on the worker thread.
+void releaseAtlasFile(void* atlasFile) {
+  delete static_cast<std::shared_ptr<QFile>*>(atlasFile);
+}
+
+class AtlasWriter : public QRunnable {
+ public:
+  AtlasWriter(const QString& path,
+              std::vector<std::pair<QByteArray, QImage>> icons,
+              IconCache* cache, const QStringList& newKeys)
+      : path_(path), icons_(std::move(icons)), cache_(cache),
+        newKeys_(newKeys) {}
+
+  void run() override {
+    const bool saved = write();
+    QMetaObject::invokeMethod(cache_, "onAtlasSaved", Qt::QueuedConnection,
+                              Q_ARG(bool, saved),
+                              Q_ARG(QStringList, newKeys_));
+  }
+
+ private:
+  bool write() {
+    QByteArray keys;
+    std::vector<quint32> records;
+    records.reserve(icons_.size() * kRecordFields);
+    const qint64 keysOffset = kHeaderSize + icons_.size() * kRecordSize;
+    for (auto& icon : icons_) {
+      icon.second = icon.second.convertToFormat(
+          QImage::Format_ARGB32_Premultiplied);
+      keys.append(icon.first);
+    }
+    qint64 dataOffset = align(keysOffset + keys.size());
+    qint64 keyOffset = keysOffset;
+    for (const auto& icon : icons_) {
+      const QImage& image = icon.second;
+      records.insert(records.end(), {
+          static_cast<quint32>(keyOffset),
+          static_cast<quint32>(icon.first.size()),
+          static_cast<quint32>(dataOffset),
+          static_cast<quint32>(image.width()),
+          static_cast<quint32>(image.height()),
+          static_cast<quint32>(image.bytesPerLine()),
+          static_cast<quint32>(image.devicePixelRatio() * 1000 + 0.5)});
+      keyOffset += icon.first.size();
+      dataOffset = align(dataOffset + image.sizeInBytes());
+    }
+    if (dataOffset > std::numeric_limits<quint32>::max()) {
+      return false;
+    }
+
+    QSaveFile file(path_);
+    if (!file.open(QIODevice::WriteOnly)) {
+      return false;
+    }
+    const quint32 header[kHeaderFields] = {
+        kAtlasMagic, IconCache::kAtlasVersion,
+        static_cast<quint32>(icons_.size()), 0};
+    file.write(reinterpret_cast<const char*>(header), kHeaderSize);
+    file.write(reinterpret_cast<const char*>(records.data()),
+               records.size() * sizeof(quint32));
+    file.write(keys);
+    for (const auto& icon : icons_) {
+      file.write(QByteArray(align(file.pos()) - file.pos(), '\0'));
+      file.write(reinterpret_cast<const char*>(icon.second.constBits()),
+                 icon.second.sizeInBytes());
+    }
+    return file.commit();
+  }
+
+  QString path_;
+  std::vector<std::pair<QByteArray, QImage>> icons_;
+  IconCache* cache_;
+  QStringList newKeys_;
+};
+
+}  // namespace
+
+constexpr int IconCache::kDefaultMaxCost;
+constexpr char IconCache::kAtlasFile[];
+constexpr quint32 IconCache::kAtlasVersion;
+constexpr int IconCache::kSaveDelayMs;
+
+IconCache* IconCache::global() {
+  static IconCache* instance = new IconCache();
+  return instance;
+}
+
+IconCache::IconCache()
+    : cache_(kDefaultMaxCost),
+      atlasData_(nullptr),
+      themeKey_(currentThemeKey()) {
+  saveTimer_.setSingleShot(true);
+  saveTimer_.setInterval(kSaveDelayMs);
+  savePool_.setMaxThreadCount(1);
+  connect(&saveTimer_, SIGNAL(timeout()), this, SLOT(saveAtlas()));
+  connect(KIconLoader::global(), SIGNAL(iconLoaderSettingsChanged()),
+          this, SLOT(clear()));
+  connect(KIconLoader::global(), SIGNAL(iconChanged(int)),
+          this, SLOT(clear()));
+}
+
+QPixmap IconCache::loadIcon(const QString& name, int size) {
+  const qreal devicePixelRatio = qApp->devicePixelRatio();
+  const QString key = name + QLatin1Char('/') + QString::number(size)
+      + QLatin1Char('@') + QString::number(devicePixelRatio);
+  if (const QPixmap* icon = cache_.object(key)) {
+    return *icon;
+  }
+
+  QPixmap icon;
+  const QString atlasKey = themeKey_ + QLatin1Char('/') + key;
+  const auto entry = atlasEntries_.constFind(atlasKey);
+  if (entry != atlasEntries_.constEnd()) {
+    // Converted in place, so that the pixmap refers to the mapped file.
+    icon = QPixmap::fromImage(atlasImage(*entry));
+  } else {
+    // KIconLoader renders at 1x, so the icon is rendered at the scaled size
+    // then marked with the device pixel ratio.
+    icon = KIconLoader::global()->loadIcon(
+        name, KIconLoader::NoGroup,
+        static_cast<int>(std::lround(size * devicePixelRatio)));
+    icon.setDevicePixelRatio(devicePixelRatio);
+    if (!atlasPath_.isEmpty() && !icon.isNull()) {
+      newIcons_.insert(atlasKey, icon.toImage());
+      if (!saveTimer_.isActive()) {
+        saveTimer_.start();
+      }
+    }
+  }
+
+  const int cost = std::max(
+      icon.width() * icon.height() * icon.depth() / 8 / 1024, 1);
+  cache_.insert(key, new QPixmap(icon), cost);
+  return icon;
+}
+
+void IconCache::setDiskCacheDir(const QString& dir) {
+  // A pending save may still write to the previous atlas path.
+  savePool_.waitForDone();
+  QDir::root().mkpath(dir);
+  atlasPath_ = QDir(dir).filePath(kAtlasFile);
+  newIcons_.clear();
+  loadAtlas();
+  connect(qApp, SIGNAL(aboutToQuit()), this, SLOT(flushAtlas()),
+          Qt::UniqueConnection);
+}
+
+void IconCache::clear() {
+  cache_.clear();
+  // The icons rendered from the previous theme are stale.
+  newIcons_.clear();
+  themeKey_ = currentThemeKey();
+}
+
+void IconCache::saveAtlas() {
+  if (atlasPath_.isEmpty() || newIcons_.isEmpty()) {
+    return;
+  }
+
+  // Entries of other themes or theme versions are dropped.
+  std::vector<std::pair<QByteArray, QImage>> icons;
+  const QString prefix = themeKey_ + QLatin1Char('/');
+  for (auto it = atlasEntries_.cbegin(); it != atlasEntries_.cend(); ++it) {
+    if (it.key().startsWith(prefix) && !newIcons_.contains(it.key())) {
+      icons.emplace_back(it.key().toUtf8(), atlasImage(it.value()));
+    }
+  }
+  for (auto it = newIcons_.cbegin(); it != newIcons_.cend(); ++it) {
+    icons.emplace_back(it.key().toUtf8(), it.value());
+  }
+  savePool_.start(
+      new AtlasWriter(atlasPath_, std::move(icons), this, newIcons_.keys()));
+}
+
+void IconCache::onAtlasSaved(bool saved, const QStringList& keys) {
+  if (!saved) {
+    return;  // will be retried with the next new icon.
+  }
+
+  // The saved icons are loaded from the new atlas from now on. The icons
+  // rendered during the save, if any, are saved next time.
+  for (const auto& key : keys) {
+    newIcons_.remove(key);
+  }
+  loadAtlas();
+}
+
+void IconCache::flushAtlas() {
+  saveTimer_.stop();
+  saveAtlas();
+  savePool_.waitForDone();
+}
+
+QString IconCache::currentThemeKey() {
+  const KIconTheme* theme = KIconLoader::global()->theme();
+  if (theme == nullptr) {
+    return QString();
+  }
+  // The theme dir changes when icons are added or removed, and index.theme
+  // when the theme is updated.
+  const QDir themeDir(theme->dir());
+  const QDateTime modified = std::max(
+      QFileInfo(themeDir.path()).lastModified(),
+      QFileInfo(themeDir.filePath("index.theme")).lastModified());
+  return theme->internalName() + QLatin1Char('@')
+      + QString::number(modified.toMSecsSinceEpoch());
+}
+
+void IconCache::loadAtlas() {
+  atlasEntries_.clear();
+  atlasData_ = nullptr;
+  atlasFile_ = std::make_shared<QFile>(atlasPath_);
+  if (!atlasFile_->open(QIODevice::ReadOnly)) {
+    return;
+  }
+  const qint64 fileSize = atlasFile_->size();
+  if (fileSize < kHeaderSize) {
+    return;
+  }
+  const uchar* data = atlasFile_->map(0, fileSize);
+  if (data == nullptr) {
+    return;
+  }
+
+  const quint32* header = reinterpret_cast<const quint32*>(data);
+  const qint64 count = header[2];
+  if (header[0] != kAtlasMagic || header[1] != kAtlasVersion
+      || count > (fileSize - kHeaderSize) / kRecordSize) {
+    return;
+  }
+
+  const quint32* records = header + kHeaderFields;
+  for (qint64 i = 0; i < count; ++i) {
+    const quint32* record = records + i * kRecordFields;
+    const qint64 keyOffset = record[0];
+    const qint64 keyLength = record[1];
+    AtlasEntry entry;
+    entry.dataOffset = record[2];
+    entry.width = static_cast<int>(record[3]);
+    entry.height = static_cast<int>(record[4]);
+    entry.bytesPerLine = static_cast<int>(record[5]);
+    entry.devicePixelRatio = record[6] / 1000.0;
+    // Skips the whole atlas if it's corrupted.
+    if (keyOffset + keyLength > fileSize || entry.dataOffset % 4 != 0
+        || entry.width <= 0 || entry.height <= 0
+        || static_cast<qint64>(entry.bytesPerLine) < 4LL * entry.width
+        || entry.dataOffset + static_cast<qint64>(entry.bytesPerLine)
+            * entry.height > fileSize
+        || entry.devicePixelRatio <= 0) {
+      atlasEntries_.clear();
+      return;
+    }
+    atlasEntries_.insert(
+        QString::fromUtf8(reinterpret_cast<const char*>(data + keyOffset),
+                          static_cast<int>(keyLength)),
+        entry);
+  }
+  atlasData_ = data;
+}
+
+QImage IconCache::atlasImage(const AtlasEntry& entry) const {
+  QImage image(atlasData_ + entry.dataOffset, entry.width, entry.height,
+               entry.bytesPerLine, QImage::Format_ARGB32_Premultiplied,
+               releaseAtlasFile, new std::shared_ptr<QFile>(atlasFile_));
+  image.setDevicePixelRatio(entry.devicePixelRatio);
+  return image;
+}
+
+}  // namespace ksmoothdock
@@ -0,0 +1,154 @@
+/*
+ * This file is part of KSmoothDock.
+ * Copyright (C) 2018 Viet Dang (dangvd@gmail.com)
+ *
+ * KSmoothDock is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * KSmoothDock is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with KSmoothDock.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KSMOOTHDOCK_ICON_CACHE_H_
+#define KSMOOTHDOCK_ICON_CACHE_H_
+
+#include <memory>
+
+#include <QCache>
+#include <QFile>
+#include <QHash>
+#include <QImage>
+#include <QObject>
+#include <QPixmap>
+#include <QString>
+#include <QStringList>
+#include <QThreadPool>
+#include <QTimer>
+
+namespace ksmoothdock {
+
+// Process-wide cache of the icons loaded from the icon theme, keyed by icon
+// name, size and device pixel ratio, so that the docks, the application menu
+// and the dialogs share the icons instead of loading them again. The icons are
+// rendered at the application's device pixel ratio, so an icon of size 32 is
+// 64 x 64 pixels on a 2x screen.
+//
+// The returned pixmaps are implicitly shared with the cache so a cached icon
+// costs its memory only once. The least recently used icons are evicted when
+// the memory budget is exceeded, and the cache is cleared when the icon theme
+// changes.
+//
+// Optionally, the rendered icons are also kept in an icon atlas on disk, keyed
+// by icon theme, theme modification time, icon name and size. The atlas is
+// memory-mapped at startup so that on a warm start the icons refer to the
+// mapped file instead of being rendered from the icon theme. Icons that are
+// missing from the atlas or stale are rendered synchronously when requested.
+// They are written to the atlas on a worker thread once no icon has been
+// rendered for a while, and on exit, then the new atlas is mapped. A replaced
+// atlas stays mapped until the last icon that refers to it is released.
+class IconCache : public QObject {
+  Q_OBJECT
+
+ public:
+  // The memory budget by default, in kilobytes.
+  static constexpr int kDefaultMaxCost = 32 * 1024;
+
+  // The file name of the icon atlas in the disk cache dir.
+  static constexpr char kAtlasFile[] = "icons.atlas";
+
+  // The version of the icon atlas file format. Atlases of other versions are
+  // ignored and rewritten.
+  static constexpr quint32 kAtlasVersion = 1;
+
+  // The delay before newly rendered icons are saved to the icon atlas, in
+  // milliseconds. Each save rewrites the whole atlas, so the icons rendered at
+  // startup or after a theme change are saved together.
+  static constexpr int kSaveDelayMs = 60000;
+
+  // Returns the global instance.
+  static IconCache* global();
+
+  // Loads the icon with the given name and size, in device-independent
+  // pixels, from the icon theme, or from the cache if it has been loaded
+  // before.
+  QPixmap loadIcon(const QString& name, int size);
+
+  // Sets the memory budget, in kilobytes.
+  void setMaxCost(int maxCost) { cache_.setMaxCost(maxCost); }
+
+  // Enables the icon atlas in the given dir and maps the existing atlas, if
+  // any. Is meant to be called once at startup, before any icon is loaded.
+  void setDiskCacheDir(const QString& dir);
+
+ public slots:
+  void clear();
+
+ private slots:
+  // Writes the icons of the current theme to the icon atlas on a worker
+  // thread.
+  void saveAtlas();
+
+  // Called when the icon atlas has been written with the given new icons.
+  void onAtlasSaved(bool saved, const QStringList& keys);
+
+  // Writes the pending icons to the icon atlas and waits for the write to
+  // finish. Called on exit.
+  void flushAtlas();
+
+ private:
+  // Location of an icon in the memory-mapped atlas.
+  struct AtlasEntry {
+    qint64 dataOffset;
+    int width;
+    int height;
+    int bytesPerLine;
+    qreal devicePixelRatio;
+  };
+
+  IconCache();
+
+  // Identifies the current icon theme and its version, as the theme's name
+  // and modification time.
+  static QString currentThemeKey();
+
+  // Maps the icon atlas file and reads its index. The previously mapped atlas,
+  // if any, is unmapped once no image refers to it.
+  void loadAtlas();
+
+  // Gets the image of an atlas entry. The image refers to the mapped memory
+  // and is read-only. It holds a reference to the atlas file until it and all
+  // its copies, including the pixmaps converted from it, are destroyed.
+  QImage atlasImage(const AtlasEntry& entry) const;
+
+  // Cost is the pixmap's memory in kilobytes.
+  QCache<QString, QPixmap> cache_;
+
+  // Empty if the icon atlas is disabled.
+  QString atlasPath_;
+  // Shared with the images of its entries, so that it's closed, and unmapped,
+  // when it has been replaced and the last of them is destroyed.
+  std::shared_ptr<QFile> atlasFile_;
+  const uchar* atlasData_;
+  QHash<QString, AtlasEntry> atlasEntries_;
+
+  // Icons rendered in this session that are not in the mapped atlas yet.
+  QHash<QString, QImage> newIcons_;
+
+  // Prefix of the atlas keys of the current icon theme.
+  QString themeKey_;
+
+  QTimer saveTimer_;
+  // Has a single thread so that the atlas is written by one save at a time.
+  QThreadPool savePool_;
+};
+
+}  // namespace ksmoothdock
+
+#endif  // KSMOOTHDOCK_ICON_CACHE_H_
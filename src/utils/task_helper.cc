@@ -43,26 +43,18 @@ QString getCommand(const KWindowInfo& info) {
   return QString(info.windowClassClass()).toLower();
 }
 
+// The window types that the tasks are filtered by.
+constexpr NET::WindowTypes kSupportedWindowTypes =
+    NET::DockMask | NET::DesktopMask;
+
 }  // namespace
 
-bool TaskInfo::operator<(const TaskInfo& taskInfo) const {
-  if (program == taskInfo.program) {
-    // If same program, sort by creation time.
-    bool found = false;
-    for (const auto window : KWindowSystem::windows()) {
-      if (window == wId) {
-        found = true;
-      } else if (window == taskInfo.wId) {
-        return found;
-      }
-    }
-    return true;
-  }
-  return program < taskInfo.program;
-}
+constexpr NET::Properties TaskHelper::kProperties;
+constexpr NET::Properties2 TaskHelper::kProperties2;
 
 TaskHelper::TaskHelper()
-    : currentDesktop_(KWindowSystem::currentDesktop()) {
+    : nextCreationOrder_(0),
+      currentDesktop_(KWindowSystem::currentDesktop()) {
   // Calling DBus to get current activity. This is more convenient than waiting for
   // KActivities::Consumer's status change then calling it.
   QDBusInterface activityManagerDBus("org.kde.ActivityManager", "/ActivityManager/Activities",
@@ -76,19 +68,38 @@ TaskHelper::TaskHelper()
 
   connect(KWindowSystem::self(), &KWindowSystem::currentDesktopChanged,
           this, &TaskHelper::onCurrentDesktopChanged);
+  connect(KWindowSystem::self(), SIGNAL(windowAdded(WId)),
+          this, SLOT(onWindowAdded(WId)));
+  connect(KWindowSystem::self(), SIGNAL(windowRemoved(WId)),
+          this, SLOT(onWindowRemoved(WId)));
+  connect(KWindowSystem::self(),
+          SIGNAL(windowChanged(WId, NET::Properties, NET::Properties2)),
+          this,
+          SLOT(onWindowChanged(WId, NET::Properties, NET::Properties2)));
   connect(&activityManager_, &KActivities::Consumer::currentActivityChanged,
           this, &TaskHelper::onCurrentActivityChanged);
 }
 
 std::vector<TaskInfo> TaskHelper::loadTasks(int screen, bool currentDesktopOnly) {
   std::vector<TaskInfo> tasks;
+  creationOrder_.clear();
+  nextCreationOrder_ = 0;
   for (const auto wId : KWindowSystem::windows()) {
+    creationOrder_[wId] = nextCreationOrder_++;
     if (isValidTask(wId, screen, currentDesktopOnly)) {
       tasks.push_back(getTaskInfo(wId));
     }
   }
 
-  std::stable_sort(tasks.begin(), tasks.end());
+  // If same program, sort by creation order.
+  std::sort(tasks.begin(), tasks.end(),
+            [this](const TaskInfo& task1, const TaskInfo& task2) {
+              if (task1.program != task2.program) {
+                return task1.program < task2.program;
+              }
+              return creationOrder_.at(task1.wId)
+                  < creationOrder_.at(task2.wId);
+            });
   return tasks;
 }
 
@@ -97,23 +108,23 @@ bool TaskHelper::isValidTask(WId wId) {
     return false;
   }
 
-  KWindowInfo info(wId, NET::WMState | NET::WMWindowType, NET::WM2WindowClass);
-  if (!info.valid()) {
+  const WindowProperties* window = getWindowProperties(wId);
+  if (window == nullptr) {
     return false;
   }
 
-  const auto windowType = info.windowType(NET::DockMask | NET::DesktopMask);
+  const auto windowType = window->windowType;
   if (windowType != NET::Normal && windowType != NET::Unknown) {
     return false;
   }
 
-  const auto state = info.state();
+  const auto state = window->state;
   if (state & NET::SkipTaskbar) {
     return false;
   }
 
   // Filters out KSmoothDock dialogs.
-  return getCommand(info) != "ksmoothdock";
+  return window->command != "ksmoothdock";
 }
 
 bool TaskHelper::isValidTask(WId wId, int screen, bool currentDesktopOnly,
@@ -126,21 +137,16 @@ bool TaskHelper::isValidTask(WId wId, int screen, bool currentDesktopOnly,
     return false;
   }
 
-  if (currentDesktopOnly) {
-    KWindowInfo info(wId, NET::WMDesktop);
-    if (!info.valid() || (info.desktop() != currentDesktop_ && !info.onAllDesktops())) {
-      return false;
-    }
+  // Is in the cache after isValidTask(wId).
+  const WindowProperties& window = windows_.at(wId);
+  if (currentDesktopOnly && !isOnDesktop(window, currentDesktop_)) {
+    return false;
   }
 
-  if (currentActivityOnly) {
-    KWindowInfo info(wId, NET::Properties(), NET::WM2Activities);
-    if (!info.valid() ||
-        (!info.activities().empty() && !info.activities().contains(currentActivity_))) {
-      return false;
-    }
+  if (currentActivityOnly && !isOnActivity(window, currentActivity_)) {
+    return false;
   }
-  
+
   return true;
 }
 
@@ -151,14 +157,18 @@ bool TaskHelper::isValidTask(WId wId, int screen, bool currentDesktopOnly,
 
 TaskInfo TaskHelper::getTaskInfo(WId wId) const {
   static constexpr int kIconLoadSize = 128;
-  KWindowInfo info(wId, NET::WMVisibleIconName | NET::WMState, NET::WM2WindowClass);
-
-  const auto program = getProgram(info);
-  const auto command = getCommand(info);
-  const auto name = info.visibleIconName();
-  QPixmap icon = KWindowSystem::icon(wId, kIconLoadSize, kIconLoadSize, true /* scale */);
+  WindowProperties* window = getWindowProperties(wId);
+  if (window == nullptr) {
+    return TaskInfo(wId, QString(), QString(), QString(), QPixmap(), false);
+  }
 
-  return TaskInfo(wId, program, command, name, icon, info.state() == NET::DemandsAttention);
+  if (window->icon.isNull()) {
+    window->icon = KWindowSystem::icon(wId, kIconLoadSize, kIconLoadSize,
+                                       true /* scale */);
+  }
+  return TaskInfo(wId, window->program, window->command,
+                  window->visibleIconName, window->icon,
+                  window->state == NET::DemandsAttention);
 }
 
 int TaskHelper::getScreen(WId wId) {
@@ -168,8 +178,12 @@ int TaskHelper::getScreen(WId wId) {
     return 0;
   }
 
-  KWindowInfo info(wId, NET::WMFrameExtents);
-  const auto& geometry = info.frameGeometry();
+  const WindowProperties* window = getWindowProperties(wId);
+  if (window == nullptr) {
+    return -1;
+  }
+
+  const auto& geometry = window->frameGeometry;
   for (int screen = 0; screen < screenCount; ++screen) {
     const auto& screenGeometry = screens[screen]->geometry();
     if (screenGeometry.intersects(geometry)) {
@@ -179,4 +193,120 @@ int TaskHelper::getScreen(WId wId) {
   return -1;
 }
 
+void TaskHelper::onWindowAdded(WId wId) {
+  creationOrder_.emplace(wId, nextCreationOrder_++);
+  if (!isValidTask(wId)) {
+    return;
+  }
+
+  // Is in the cache after isValidTask(wId).
+  const WindowProperties& window = windows_.at(wId);
+  if (isOnActivity(window, currentActivity_)) {
+    emit taskAdded(getTaskInfo(wId), getScreen(wId),
+                   isOnDesktop(window, currentDesktop_));
+  }
+}
+
+void TaskHelper::onWindowRemoved(WId wId) {
+  windows_.erase(wId);
+  creationOrder_.erase(wId);
+  emit taskRemoved(wId);
+}
+
+void TaskHelper::onWindowChanged(WId wId, NET::Properties properties,
+                                 NET::Properties2 properties2) {
+  updateWindowProperties(wId, properties, properties2);
+  if (!isValidTask(wId)) {
+    return;
+  }
+
+  if (properties & (NET::WMDesktop | NET::WMGeometry)) {
+    const WindowProperties& window = windows_.at(wId);
+    if (isOnActivity(window, currentActivity_)) {
+      emit taskMoved(getTaskInfo(wId), getScreen(wId),
+                     isOnDesktop(window, currentDesktop_));
+    } else {
+      emit taskRemoved(wId);
+    }
+  } else if (properties & (NET::WMState | NET::WMName | NET::WMIconName |
+                           NET::WMVisibleName | NET::WMVisibleIconName)) {
+    emit taskChanged(getTaskInfo(wId));
+  }
+}
+
+void TaskHelper::updateWindowProperties(WId wId, NET::Properties properties,
+                                        NET::Properties2 properties2) {
+  auto it = windows_.find(wId);
+  if (it == windows_.end()) {
+    return;  // will be fetched when needed.
+  }
+
+  // Maps the changed properties to the cached ones that depend on them.
+  if (properties & (NET::WMName | NET::WMVisibleName | NET::WMIconName)) {
+    properties |= NET::WMVisibleIconName;
+  }
+  if (properties & NET::WMGeometry) {
+    properties |= NET::WMFrameExtents;
+  }
+  if (properties & NET::WMIcon) {
+    it->second.icon = QPixmap();
+  }
+  properties &= kProperties;
+  properties2 &= kProperties2;
+  if (!properties && !properties2) {
+    return;
+  }
+
+  KWindowInfo info(wId, properties, properties2);
+  if (!info.valid()) {
+    windows_.erase(it);
+    return;
+  }
+  fetchWindowProperties(info, properties, properties2, &it->second);
+}
+
+TaskHelper::WindowProperties* TaskHelper::getWindowProperties(
+    WId wId) const {
+  auto it = windows_.find(wId);
+  if (it != windows_.end()) {
+    return &it->second;
+  }
+
+  KWindowInfo info(wId, kProperties, kProperties2);
+  if (!info.valid()) {
+    return nullptr;
+  }
+  WindowProperties window;
+  fetchWindowProperties(info, kProperties, kProperties2, &window);
+  return &windows_.emplace(wId, window).first->second;
+}
+
+/* static */ void TaskHelper::fetchWindowProperties(
+    const KWindowInfo& info, NET::Properties properties,
+    NET::Properties2 properties2, WindowProperties* window) {
+  if (properties & NET::WMWindowType) {
+    window->windowType = info.windowType(kSupportedWindowTypes);
+  }
+  if (properties & NET::WMState) {
+    window->state = info.state();
+  }
+  if (properties & NET::WMVisibleIconName) {
+    window->visibleIconName = info.visibleIconName();
+  }
+  if (properties & NET::WMFrameExtents) {
+    window->frameGeometry = info.frameGeometry();
+  }
+  if (properties & NET::WMDesktop) {
+    window->desktop = info.desktop();
+    window->onAllDesktops = info.onAllDesktops();
+  }
+  if (properties2 & NET::WM2WindowClass) {
+    window->program = getProgram(info);
+    window->command = getCommand(info);
+  }
+  if (properties2 & NET::WM2Activities) {
+    window->activities = info.activities();
+  }
+}
+
 }  // namespace ksmoothdock
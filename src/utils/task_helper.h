@@ -19,13 +19,18 @@
 #ifndef KSMOOTHDOCK_TASK_HELPER_H_
 #define KSMOOTHDOCK_TASK_HELPER_H_
 
+#include <unordered_map>
 #include <vector>
 
 #include <QObject>
 #include <QPixmap>
+#include <QRect>
 #include <QString>
+#include <QStringList>
 
+#include <KWindowInfo>
 #include <kactivities/consumer.h>
+#include <netwm_def.h>
 
 namespace ksmoothdock {
 
@@ -44,17 +49,17 @@ struct TaskInfo {
         demandsAttention(demandsAttention2) {}
   TaskInfo(const TaskInfo& taskInfo) = default;
   TaskInfo& operator=(const TaskInfo& taskInfo) = default;
-
-  bool operator<(const TaskInfo& taskInfo) const;
 };
 
+// Tracks the running tasks for all the docks. It validates the tasks and
+// fetches their properties once per window event, then signals the docks.
 class TaskHelper : public QObject {
   Q_OBJECT
 
  public:
   TaskHelper();
 
-  // Loads running tasks.
+  // Loads running tasks, sorted by program then by creation order.
   //
   // Args:
   //   screen: screen index to load, or -1 if loading for all screens.
@@ -74,16 +79,103 @@ class TaskHelper : public QObject {
   // Gets the screen that a task is running on.
   int getScreen(WId wId);
 
+ signals:
+  // A valid task in the current activity has been added.
+  //
+  // Args:
+  //   screen: the screen that the task is on, or -1 if unknown.
+  //   onCurrentDesktop: whether the task is on the current desktop.
+  void taskAdded(const TaskInfo& task, int screen, bool onCurrentDesktop);
+
+  // A valid task in the current activity has moved to another desktop or
+  // screen. Same args as taskAdded().
+  void taskMoved(const TaskInfo& task, int screen, bool onCurrentDesktop);
+
+  // A task has been closed or has moved out of the current activity.
+  void taskRemoved(WId wId);
+
+  // The name or the state of a valid task has changed.
+  void taskChanged(const TaskInfo& task);
+
+  // Emitted after the current desktop/activity has been updated.
+  void currentDesktopChanged();
+  void currentActivityChanged();
+
  public slots:
+  // Keep the window properties cache and the creation order up to date, then
+  // signal the changes to the tasks.
+  void onWindowAdded(WId wId);
+  void onWindowRemoved(WId wId);
+  void onWindowChanged(WId wId, NET::Properties properties,
+                       NET::Properties2 properties2);
+
   void onCurrentDesktopChanged(int desktop) {
     currentDesktop_ = desktop;
+    emit currentDesktopChanged();
   }
 
   void onCurrentActivityChanged(QString activity) {
     currentActivity_ = activity;
+    emit currentActivityChanged();
   }
 
  private:
+  // The properties of a window that are used for the tasks.
+  struct WindowProperties {
+    NET::WindowType windowType;
+    NET::States state;
+    QString program;
+    QString command;
+    QString visibleIconName;
+    QRect frameGeometry;
+    int desktop;
+    bool onAllDesktops;
+    QStringList activities;
+    // Loaded on demand as it's costly.
+    QPixmap icon;
+  };
+
+  // The properties in the window properties cache.
+  static constexpr NET::Properties kProperties = NET::WMState
+      | NET::WMWindowType | NET::WMVisibleIconName | NET::WMFrameExtents
+      | NET::WMDesktop;
+  static constexpr NET::Properties2 kProperties2 =
+      NET::WM2WindowClass | NET::WM2Activities;
+
+  // Gets the cached properties of a window, fetching all of them from the
+  // window system if the window is not in the cache yet. Returns nullptr if
+  // the window is not valid.
+  WindowProperties* getWindowProperties(WId wId) const;
+
+  // Refetches the cached properties that depend on the changed ones.
+  void updateWindowProperties(WId wId, NET::Properties properties,
+                              NET::Properties2 properties2);
+
+  static bool isOnDesktop(const WindowProperties& window, int desktop) {
+    return window.desktop == desktop || window.onAllDesktops;
+  }
+
+  static bool isOnActivity(const WindowProperties& window,
+                           const QString& activity) {
+    return window.activities.empty() || window.activities.contains(activity);
+  }
+
+  // Fetches the specified properties of a window in a single query.
+  static void fetchWindowProperties(const KWindowInfo& info,
+                                    NET::Properties properties,
+                                    NET::Properties2 properties2,
+                                    WindowProperties* window);
+
+  // The window properties cache. A window's properties are fetched once, then
+  // only the ones that have changed are fetched again.
+  mutable std::unordered_map<WId, WindowProperties> windows_;
+
+  // The creation order of the windows, as in KWindowSystem::windows(), which
+  // lists the windows from the oldest to the newest. It's rebuilt by
+  // loadTasks() and maintained as windows are added and removed.
+  std::unordered_map<WId, qint64> creationOrder_;
+  qint64 nextCreationOrder_;
+
   // KWindowSystem::currentDesktop() is buggy sometimes, for example,
   // on windowAdded() event, so we store it here ourselves.
   int currentDesktop_;
@@ -76,6 +76,12 @@ void AppearanceSettingsDialog::loadData() {
   ui->minSize->setValue(model_->minIconSize());
   ui->maxSize->setValue(model_->maxIconSize());
   ui->spacingFactor->setValue(model_->spacingFactor());
+  ui->zoomCurve->setCurrentIndex(static_cast<int>(model_->zoomCurve()));
+  ui->zoomUpdateRate->setValue(model_->zoomUpdateRate());
+  ui->animationDuration->setValue(model_->animationDuration());
+  ui->animationCurve->setCurrentIndex(
+      static_cast<int>(model_->animationCurve()));
+  ui->fixedSizeWindow->setChecked(model_->fixedSizeWindow());
   QColor backgroundColor = model_->backgroundColor();
   backgroundColor_->setColor(QColor(backgroundColor.rgb()));
   ui->backgroundTransparency->setValue(alphaFToTransparencyPercent(backgroundColor.alphaF()));
@@ -88,6 +94,12 @@ void AppearanceSettingsDialog::resetData() {
   ui->minSize->setValue(kDefaultMinSize);
   ui->maxSize->setValue(kDefaultMaxSize);
   ui->spacingFactor->setValue(kDefaultSpacingFactor);
+  ui->zoomCurve->setCurrentIndex(static_cast<int>(kDefaultZoomCurve));
+  ui->zoomUpdateRate->setValue(kDefaultZoomUpdateRate);
+  ui->animationDuration->setValue(kDefaultAnimationDuration);
+  ui->animationCurve->setCurrentIndex(
+      static_cast<int>(kDefaultAnimationCurve));
+  ui->fixedSizeWindow->setChecked(kDefaultFixedSizeWindow);
   backgroundColor_->setColor(QColor(kDefaultBackgroundColor));
   ui->backgroundTransparency->setValue(alphaFToTransparencyPercent(kDefaultBackgroundAlpha));
   ui->showBorder->setChecked(kDefaultShowBorder);
@@ -99,6 +111,12 @@ void AppearanceSettingsDialog::saveData() {
   model_->setMinIconSize(ui->minSize->value());
   model_->setMaxIconSize(ui->maxSize->value());
   model_->setSpacingFactor(ui->spacingFactor->value());
+  model_->setZoomCurve(static_cast<ZoomCurve>(ui->zoomCurve->currentIndex()));
+  model_->setZoomUpdateRate(ui->zoomUpdateRate->value());
+  model_->setAnimationDuration(ui->animationDuration->value());
+  model_->setAnimationCurve(
+      static_cast<AnimationCurve>(ui->animationCurve->currentIndex()));
+  model_->setFixedSizeWindow(ui->fixedSizeWindow->isChecked());
   QColor backgroundColor(backgroundColor_->color());
   backgroundColor.setAlphaF(transparencyPercentToAlphaF(ui->backgroundTransparency->value()));
   model_->setBackgroundColor(backgroundColor);
@@ -39,6 +39,11 @@ class AppearanceSettingsDialogTest: public QObject {
     model_->setMinIconSize(48);
     model_->setMaxIconSize(128);
     model_->setSpacingFactor(0.5);
+    model_->setZoomCurve(ZoomCurve::Parabolic);
+    model_->setZoomUpdateRate(60);
+    model_->setAnimationDuration(320);
+    model_->setAnimationCurve(AnimationCurve::Linear);
+    model_->setFixedSizeWindow(false);
     QColor color("white");
     color.setAlphaF(0.42);
     model_->setBackgroundColor(color);
@@ -75,6 +80,13 @@ void AppearanceSettingsDialogTest::uiInit() {
   QCOMPARE(dialog_->ui->minSize->value(), 48);
   QCOMPARE(dialog_->ui->maxSize->value(), 128);
   compareDouble(dialog_->ui->spacingFactor->value(), 0.5);
+  QCOMPARE(dialog_->ui->zoomCurve->currentIndex(),
+           static_cast<int>(ZoomCurve::Parabolic));
+  QCOMPARE(dialog_->ui->zoomUpdateRate->value(), 60);
+  QCOMPARE(dialog_->ui->animationDuration->value(), 320);
+  QCOMPARE(dialog_->ui->animationCurve->currentIndex(),
+           static_cast<int>(AnimationCurve::Linear));
+  QCOMPARE(dialog_->ui->fixedSizeWindow->isChecked(), false);
   QCOMPARE(dialog_->backgroundColor_->color(), QColor("white"));
   QCOMPARE(dialog_->ui->backgroundTransparency->value(), 58);
   QCOMPARE(dialog_->ui->showBorder->isChecked(), true);
@@ -86,6 +98,12 @@ void AppearanceSettingsDialogTest::ok() {
   dialog_->ui->minSize->setValue(40);
   dialog_->ui->maxSize->setValue(80);
   dialog_->ui->spacingFactor->setValue(0.2);
+  dialog_->ui->zoomCurve->setCurrentIndex(static_cast<int>(ZoomCurve::Cosine));
+  dialog_->ui->zoomUpdateRate->setValue(120);
+  dialog_->ui->animationDuration->setValue(200);
+  dialog_->ui->animationCurve->setCurrentIndex(
+      static_cast<int>(AnimationCurve::OutCubic));
+  dialog_->ui->fixedSizeWindow->setChecked(true);
   dialog_->ui->backgroundTransparency->setValue(90);
   dialog_->backgroundColor_->setColor(QColor("green"));
   dialog_->ui->showBorder->setChecked(false);
@@ -99,6 +117,11 @@ void AppearanceSettingsDialogTest::ok() {
   QCOMPARE(model_->minIconSize(), 40);
   QCOMPARE(model_->maxIconSize(), 80);
   compareDouble(dialog_->ui->spacingFactor->value(), 0.2);
+  QCOMPARE(model_->zoomCurve(), ZoomCurve::Cosine);
+  QCOMPARE(model_->zoomUpdateRate(), 120);
+  QCOMPARE(model_->animationDuration(), 200);
+  QCOMPARE(model_->animationCurve(), AnimationCurve::OutCubic);
+  QCOMPARE(model_->fixedSizeWindow(), true);
   QCOMPARE(model_->backgroundColor().rgb(), QColor("green").rgb());
   compareDouble(model_->backgroundColor().alphaF(), 0.1);
   QCOMPARE(model_->showBorder(), false);
@@ -110,6 +133,12 @@ void AppearanceSettingsDialogTest::apply() {
   dialog_->ui->minSize->setValue(40);
   dialog_->ui->maxSize->setValue(80);
   dialog_->ui->spacingFactor->setValue(0.2);
+  dialog_->ui->zoomCurve->setCurrentIndex(static_cast<int>(ZoomCurve::Cosine));
+  dialog_->ui->zoomUpdateRate->setValue(120);
+  dialog_->ui->animationDuration->setValue(200);
+  dialog_->ui->animationCurve->setCurrentIndex(
+      static_cast<int>(AnimationCurve::OutCubic));
+  dialog_->ui->fixedSizeWindow->setChecked(true);
   dialog_->ui->backgroundTransparency->setValue(90);
   dialog_->backgroundColor_->setColor(QColor("green"));
   dialog_->ui->showBorder->setChecked(false);
@@ -123,6 +152,11 @@ void AppearanceSettingsDialogTest::apply() {
   QCOMPARE(model_->minIconSize(), 40);
   QCOMPARE(model_->maxIconSize(), 80);
   compareDouble(dialog_->ui->spacingFactor->value(), 0.2);
+  QCOMPARE(model_->zoomCurve(), ZoomCurve::Cosine);
+  QCOMPARE(model_->zoomUpdateRate(), 120);
+  QCOMPARE(model_->animationDuration(), 200);
+  QCOMPARE(model_->animationCurve(), AnimationCurve::OutCubic);
+  QCOMPARE(model_->fixedSizeWindow(), true);
   QCOMPARE(model_->backgroundColor().rgb(), QColor("green").rgb());
   compareDouble(model_->backgroundColor().alphaF(), 0.1);
   QCOMPARE(model_->showBorder(), false);
@@ -134,6 +168,12 @@ void AppearanceSettingsDialogTest::cancel() {
   dialog_->ui->minSize->setValue(40);
   dialog_->ui->maxSize->setValue(80);
   dialog_->ui->spacingFactor->setValue(0.2);
+  dialog_->ui->zoomCurve->setCurrentIndex(static_cast<int>(ZoomCurve::Cosine));
+  dialog_->ui->zoomUpdateRate->setValue(120);
+  dialog_->ui->animationDuration->setValue(200);
+  dialog_->ui->animationCurve->setCurrentIndex(
+      static_cast<int>(AnimationCurve::OutCubic));
+  dialog_->ui->fixedSizeWindow->setChecked(true);
   dialog_->ui->backgroundTransparency->setValue(90);
   dialog_->backgroundColor_->setColor(QColor("green"));
   dialog_->ui->showBorder->setChecked(false);
@@ -147,6 +187,11 @@ void AppearanceSettingsDialogTest::cancel() {
   QCOMPARE(model_->minIconSize(), 48);
   QCOMPARE(model_->maxIconSize(), 128);
   compareDouble(dialog_->ui->spacingFactor->value(), 0.5);
+  QCOMPARE(model_->zoomCurve(), ZoomCurve::Parabolic);
+  QCOMPARE(model_->zoomUpdateRate(), 60);
+  QCOMPARE(model_->animationDuration(), 320);
+  QCOMPARE(model_->animationCurve(), AnimationCurve::Linear);
+  QCOMPARE(model_->fixedSizeWindow(), false);
   QCOMPARE(model_->backgroundColor().rgb(), QColor("white").rgb());
   compareDouble(model_->backgroundColor().alphaF(), 0.42);
   QCOMPARE(model_->showBorder(), true);
@@ -27,13 +27,13 @@
 #include <QUrl>
 
 #include <KDesktopFile>
-#include <KIconLoader>
 #include <KLocalizedString>
 #include <KWindowSystem>
 
 #include "dock_panel.h"
 #include "program.h"
 #include <utils/draw_utils.h>
+#include <utils/icon_cache.h>
 
 namespace ksmoothdock {
 
@@ -72,12 +72,11 @@ ApplicationMenu::ApplicationMenu(
           this, SLOT(reloadMenu()));
 }
 
-void ApplicationMenu::draw(QPainter* painter) const {
+void ApplicationMenu::drawHighlight(QPainter* painter) const {
   if (showingMenu_) {
-    drawHighlightedIcon(model_->backgroundColor(), left_, top_, getWidth(), getHeight(),
-                        minSize_ / 4 - 4, size_ / 8, painter);
+    drawHighlightedIcon(model_->backgroundColor(), left(), top(), getWidth(), getHeight(),
+                        minSize_ / 4 - 4, size() / 8, painter);
   }
-  IconBasedDockItem::draw(painter);
 }
 
 void ApplicationMenu::mousePressEvent(QMouseEvent *e) {
@@ -199,8 +198,7 @@ void ApplicationMenu::addEntry(const ApplicationEntry &entry, QMenu *menu) {
 }
 
 QIcon ApplicationMenu::loadIcon(const QString &icon) {
-  return QIcon(KIconLoader::global()->loadIcon(
-      icon, KIconLoader::NoGroup, kApplicationMenuIconSize));
+  return QIcon(IconCache::global()->loadIcon(icon, kApplicationMenuIconSize));
 }
 
 void ApplicationMenu::createContextMenu() {
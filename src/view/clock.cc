@@ -38,6 +38,7 @@ namespace ksmoothdock {
 
 constexpr float Clock::kWhRatio;
 constexpr float Clock::kDelta;
+constexpr int Clock::kUpdateIntervalMs;
 
 Clock::Clock(DockPanel* parent, MultiDockModel* model,
              Qt::Orientation orientation, int minSize, int maxSize)
@@ -45,32 +46,41 @@ Clock::Clock(DockPanel* parent, MultiDockModel* model,
                        kWhRatio),
       model_(model),
       calendar_(parent),
-      fontFamilyGroup_(this) {
+      fontFamilyGroup_(this),
+      timeFormat_(timeFormat()),
+      time_(QTime::currentTime().toString(timeFormat_)) {
   createMenu();
   loadConfig();
 
-  QTimer* timer = new QTimer(this);
-  connect(timer, SIGNAL(timeout()), this, SLOT(updateTime()));
-  timer->start(1000);  // update the time every second.
+  timer_.setSingleShot(true);
+  timer_.setTimerType(Qt::PreciseTimer);
+  connect(&timer_, SIGNAL(timeout()), this, SLOT(updateTime()));
+  scheduleUpdate();
 }
 
 void Clock::draw(QPainter *painter) const {
-  const QString timeFormat = model_->use24HourClock() ? "hh:mm" : "hh:mm AP";
-  const QString time = QTime::currentTime().toString(timeFormat);
-  // The reference time used to calculate the font size.
-  const QString referenceTime = QTime(8, 8).toString(timeFormat);
+  // The time format may have been changed by another dock.
+  const QString timeFormat = this->timeFormat();
+  if (timeFormat != timeFormat_) {
+    timeFormat_ = timeFormat;
+    time_ = QTime::currentTime().toString(timeFormat_);
+  }
+  const QString& time = time_;
 
+  // The reference time used to calculate the font size. The font is cached by
+  // adjustFontSize().
+  const QString referenceTime = QTime(8, 8).toString(timeFormat);
   painter->setFont(adjustFontSize(getWidth(), getHeight(), referenceTime,
                                   model_->clockFontScaleFactor(),
                                   model_->clockFontFamily()));
   painter->setRenderHint(QPainter::TextAntialiasing);
 
-  if (size_ > minSize_) {
-    drawBorderedText(left_, top_, getWidth(), getHeight(), Qt::AlignCenter,
+  if (size() > minSize_) {
+    drawBorderedText(left(), top(), getWidth(), getHeight(), Qt::AlignCenter,
                      time, 2 /* borderWidth */, Qt::black, Qt::white, painter);
   } else {
     painter->setPen(Qt::white);
-    painter->drawText(left_, top_, getWidth(), getHeight(), Qt::AlignCenter,
+    painter->drawText(left(), top(), getWidth(), getHeight(), Qt::AlignCenter,
                       time);
   }
 }
@@ -90,7 +100,20 @@ QString Clock::getLabel() const {
 }
 
 void Clock::updateTime() {
-  parent_->update();
+  const QString time = QTime::currentTime().toString(timeFormat_);
+  if (time != time_) {
+    time_ = time;
+    parent_->updateItem(this);
+  }
+  scheduleUpdate();
+}
+
+void Clock::scheduleUpdate() {
+  // Every second rather than at the next minute, as the timer doesn't know
+  // about suspends and clock changes, so that the time is right again within
+  // a second after them.
+  const int msecs = QTime::currentTime().msecsSinceStartOfDay();
+  timer_.start(kUpdateIntervalMs - msecs % kUpdateIntervalMs);
 }
 
 void Clock::setDateAndTime() {
@@ -26,6 +26,7 @@
 #include <QMenu>
 #include <QObject>
 #include <QString>
+#include <QTimer>
 
 #include "calendar.h"
 #include <model/multi_dock_model.h>
@@ -33,6 +34,9 @@
 namespace ksmoothdock {
 
 // A digital clock.
+//
+// It's updated when the displayed time changes, i.e. at the start of every
+// minute, and only repaints its own part of the dock.
 class Clock : public QObject, public IconlessDockItem {
   Q_OBJECT
 
@@ -45,7 +49,6 @@ class Clock : public QObject, public IconlessDockItem {
   void mousePressEvent(QMouseEvent* e) override;
   void loadConfig() override;
   QString getLabel() const override;
-  bool beforeTask(const QString& command) override { return false; }
 
  public slots:
   void updateTime();
@@ -60,6 +63,8 @@ class Clock : public QObject, public IconlessDockItem {
  private:
   static constexpr float kWhRatio = 2.8;
   static constexpr float kDelta = 0.01;
+  // The interval between two checks of the displayed time, in milliseconds.
+  static constexpr int kUpdateIntervalMs = 1000;
 
   float fontScaleFactor() {
     return largeFontAction_->isChecked()
@@ -68,6 +73,14 @@ class Clock : public QObject, public IconlessDockItem {
                                          : kSmallClockFontScaleFactor;
   }
 
+  QString timeFormat() const {
+    return model_->use24HourClock() ? "hh:mm" : "hh:mm AP";
+  }
+
+  // Schedules the next check of the displayed time, at the start of the next
+  // second. The clock is only repainted if the displayed time has changed.
+  void scheduleUpdate();
+
   // Creates the context menu.
   void createMenu();
 
@@ -86,6 +99,12 @@ class Clock : public QObject, public IconlessDockItem {
   QAction* smallFontAction_;
 
   QActionGroup fontFamilyGroup_;
+
+  QTimer timer_;
+
+  // The displayed time and its format.
+  mutable QString timeFormat_;
+  mutable QString time_;
 };
 
 }  // namespace ksmoothdock
@@ -50,14 +50,16 @@ DesktopSelector::DesktopSelector(DockPanel* parent, MultiDockModel* model,
   loadConfig();
 }
 
+const QPixmap* DesktopSelector::getCurrentIcon() const {
+  return hasCustomWallpaper_ ? IconBasedDockItem::getCurrentIcon() : nullptr;
+}
+
 void DesktopSelector::draw(QPainter* painter) const {
-  if (hasCustomWallpaper_) {
-    IconBasedDockItem::draw(painter);
-  } else {
+  if (!hasCustomWallpaper_) {
     // Draw rectangles with desktop numbers if no custom wallpapers set.
     QColor fillColor = model_->backgroundColor().lighter();
     fillColor.setAlphaF(0.42);
-    painter->fillRect(left_, top_, getWidth(), getHeight(), QBrush(fillColor));
+    painter->fillRect(left(), top(), getWidth(), getHeight(), QBrush(fillColor));
   }
 
   if (model_->showDesktopNumber()) {
@@ -65,7 +67,7 @@ void DesktopSelector::draw(QPainter* painter) const {
                                     "0" /* reference string */,
                                     0.5 /* scale factor */));
     painter->setRenderHint(QPainter::TextAntialiasing);
-    drawBorderedText(left_, top_, getWidth(), getHeight(), Qt::AlignCenter,
+    drawBorderedText(left(), top(), getWidth(), getHeight(), Qt::AlignCenter,
                      QString::number(desktop_), 1 /* borderWidth */, Qt::black,
                      Qt::white, painter);
   }
@@ -73,7 +75,7 @@ void DesktopSelector::draw(QPainter* painter) const {
   // Draw the border for the current desktop.
   if (isCurrentDesktop()) {
     painter->setPen(model_->borderColor());
-    painter->drawRect(left_ - 1, top_ - 1, getWidth() + 1, getHeight() + 1);
+    painter->drawRect(left() - 1, top() - 1, getWidth() + 1, getHeight() + 1);
   }
 }
 
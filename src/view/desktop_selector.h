@@ -53,6 +53,7 @@ class DesktopSelector : public QObject, public IconBasedDockItem {
     return isHorizontal() ? size : (size * desktopHeight_ / desktopWidth_);
   }
 
+  const QPixmap* getCurrentIcon() const override;
   void draw(QPainter* painter) const override;
   void mousePressEvent(QMouseEvent* e) override;
   void loadConfig() override;
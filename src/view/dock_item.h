@@ -21,9 +21,11 @@
 
 #include <QMouseEvent>
 #include <QPainter>
+#include <QPixmap>
 #include <QString>
 #include <Qt>
 
+#include "dock_item_geometry.h"
 #include <utils/task_helper.h>
 
 namespace ksmoothdock {
@@ -39,7 +41,7 @@ class DockItem {
   DockItem(DockPanel* parent, const QString& label,
       Qt::Orientation orientation, int minSize, int maxSize)
       : parent_(parent), label_(label), orientation_(orientation),
-        minSize_(minSize), maxSize_(maxSize), size_(minSize) {}
+        minSize_(minSize), maxSize_(maxSize), geometry_(nullptr), slot_(-1) {}
   virtual ~DockItem() {}
 
   // Gets the width of the item given a size.
@@ -48,8 +50,18 @@ class DockItem {
   // Gets the height of the item given a size.
   virtual int getHeightForSize(int size) const = 0;
 
-  // Draws itself on the parent's canvas.
-  virtual void draw(QPainter* painter) const = 0;
+  // The parent draws its items in three passes so that each pass can be
+  // batched: the highlights of all the items, then their icons, then the rest.
+
+  // Draws the highlight behind the icon, if any, on the parent's canvas.
+  virtual void drawHighlight(QPainter* painter) const {}
+
+  // Gets the icon at the current size, centered in the item by the parent, or
+  // nullptr if the item has no icon.
+  virtual const QPixmap* getCurrentIcon() const { return nullptr; }
+
+  // Draws the rest of itself, e.g. text, on the parent's canvas.
+  virtual void draw(QPainter* painter) const {}
 
   // Mouse press event handler.
   virtual void mousePressEvent(QMouseEvent* e) = 0;
@@ -71,8 +83,8 @@ class DockItem {
   // Does this (Program) dock item already have this task?
   virtual bool hasTask(WId wId) { return false; }
 
-  // Will this item be ordered before the Program item for this task?
-  virtual bool beforeTask(const QString& command) { return true; }
+  // The command of the tasks that this (Program) dock item groups, if any.
+  virtual QString getTaskCommand() const { return QString(); }
 
   // Should be removed for example if a Program item has no task and is not pinned.
   virtual bool shouldBeRemoved() { return false; }
@@ -83,34 +95,11 @@ class DockItem {
 
   bool isHorizontal() const { return orientation_ == Qt::Horizontal; }
 
-  void setAnimationStartAsCurrent() {
-    startLeft_ = left_;
-    startTop_ = top_;
-    startSize_ = size_;
-  }
-
-  void setAnimationEndAsCurrent() {
-    endLeft_ = left_;
-    endTop_ = top_;
-    endSize_ = size_;
-  }
-
-  void startAnimation(int numSteps) {
-    left_ = startLeft_;
-    top_ = startTop_;
-    size_ = startSize_;
-    currentStep_ = 0;
-    numSteps_ = numSteps;
-  }
-
-  void nextAnimationStep() {
-    ++currentStep_;
-    if (currentStep_ <= numSteps_) {
-      left_ = startLeft_ + (endLeft_ - startLeft_) * currentStep_ / numSteps_;
-      top_ = startTop_ + (endTop_ - startTop_) * currentStep_ / numSteps_;
-      size_ = startSize_ + (endSize_ - startSize_) * currentStep_ / numSteps_;
-    }
-  }
+  // The item's geometry, stored in the parent's geometry buffer. An item that
+  // has not been added to a panel yet is at its min size.
+  int left() const { return geometry_ ? geometry_->left(slot_) : 0; }
+  int top() const { return geometry_ ? geometry_->top(slot_) : 0; }
+  int size() const { return geometry_ ? geometry_->size(slot_) : minSize_; }
 
   // Gets max width, i.e. the width when the item is max zoomed.
   int getMaxWidth() const {
@@ -133,11 +122,11 @@ class DockItem {
   }
 
   int getWidth() const {
-    return getWidthForSize(size_);
+    return getWidthForSize(size());
   }
 
   int getHeight() const {
-    return getHeightForSize(size_);
+    return getHeightForSize(size());
   }
 
  protected:
@@ -147,25 +136,12 @@ class DockItem {
   int minSize_;
   int maxSize_;
 
-  int size_;
-  int left_;
-  int top_;
-  // Center when minimized, as x or y depends on whether the orientation is
-  // horizontal or vertical. This is used when calculating the size of the item
-  // when the dock is in parabolic zoom.
-  int minCenter_; 
-
-  // For animation.
-  int startLeft_;
-  int startTop_;
-  int startSize_;
-  int endLeft_;
-  int endTop_;
-  int endSize_;
-  int currentStep_;
-  int numSteps_;
-
  private:
+  // The parent's geometry buffer and the index of this item in it, set by the
+  // parent when the item is added.
+  const DockItemGeometry* geometry_;
+  int slot_;
+
   friend class DockPanel;
 };
 
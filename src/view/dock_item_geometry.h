@@ -0,0 +1,169 @@
+/*
+ * This file is part of KSmoothDock.
+ * Copyright (C) 2017 Viet Dang (dangvd@gmail.com)
+ *
+ * KSmoothDock is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * KSmoothDock is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with KSmoothDock.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KSMOOTHDOCK_DOCK_ITEM_GEOMETRY_H_
+#define KSMOOTHDOCK_DOCK_ITEM_GEOMETRY_H_
+
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+
+namespace ksmoothdock {
+
+// Geometry and animation state of all the items of a dock panel, stored as
+// struct-of-arrays so that the layout and animation loops run over contiguous
+// memory. Each dock item reads its own slot by index.
+//
+// The animated fields (left, top and size) are stored as consecutive blocks of
+// count() values each in the current, start and end arrays, followed by the
+// background's width and height, so that an animation step is a single pass
+// over these arrays.
+class DockItemGeometry {
+ public:
+  DockItemGeometry()
+      : count_(0),
+        current_(kNumBackgroundFields, 0),
+        start_(kNumBackgroundFields, 0),
+        end_(kNumBackgroundFields, 0) {}
+
+  int count() const { return count_; }
+
+  int& left(int i) { return current_[kLeft * count_ + i]; }
+  int left(int i) const { return current_[kLeft * count_ + i]; }
+  int& top(int i) { return current_[kTop * count_ + i]; }
+  int top(int i) const { return current_[kTop * count_ + i]; }
+  int& size(int i) { return current_[kSize * count_ + i]; }
+  int size(int i) const { return current_[kSize * count_ + i]; }
+
+  // Center when minimized, as x or y depends on whether the orientation is
+  // horizontal or vertical. This is used when calculating the size of the item
+  // when the dock is in parabolic zoom.
+  int& minCenter(int i) { return minCenter_[i]; }
+  int minCenter(int i) const { return minCenter_[i]; }
+  const std::vector<int>& minCenters() const { return minCenter_; }
+
+  // For animation.
+  int& startLeft(int i) { return start_[kLeft * count_ + i]; }
+  int& startTop(int i) { return start_[kTop * count_ + i]; }
+  int& startSize(int i) { return start_[kSize * count_ + i]; }
+  int& endLeft(int i) { return end_[kLeft * count_ + i]; }
+  int& endTop(int i) { return end_[kTop * count_ + i]; }
+  int& endSize(int i) { return end_[kSize * count_ + i]; }
+
+  // Background's width and height, animated together with the items.
+  int& backgroundWidth() { return current_[backgroundIndex(kWidth)]; }
+  int backgroundWidth() const { return current_[backgroundIndex(kWidth)]; }
+  int& backgroundHeight() { return current_[backgroundIndex(kHeight)]; }
+  int backgroundHeight() const { return current_[backgroundIndex(kHeight)]; }
+  int& startBackgroundWidth() { return start_[backgroundIndex(kWidth)]; }
+  int& startBackgroundHeight() { return start_[backgroundIndex(kHeight)]; }
+  int& endBackgroundWidth() { return end_[backgroundIndex(kWidth)]; }
+  int& endBackgroundHeight() { return end_[backgroundIndex(kHeight)]; }
+
+  void setAnimationStartAsCurrent() { start_ = current_; }
+
+  void setAnimationEndAsCurrent() { end_ = current_; }
+
+  void startAnimation() { current_ = start_; }
+
+  // Sets all the animated values to the linear interpolation between the
+  // start and the end values at the given progress, from 0 to 1.
+  //
+  // This uses 16.16 fixed-point arithmetic with the progress converted once,
+  // so the loop has no division or branch and can be vectorized. Progress 1
+  // gives the end values exactly.
+  void setAnimationProgress(double progress) {
+    if (progress >= 1.0) {
+      current_ = end_;
+      return;
+    }
+
+    const int32_t t = (progress <= 0.0)
+        ? 0 : static_cast<int32_t>(progress * (1 << kFractionBits) + 0.5);
+    const int n = static_cast<int>(current_.size());
+    const int* start = start_.data();
+    const int* end = end_.data();
+    int* current = current_.data();
+    for (int i = 0; i < n; ++i) {
+      current[i] = start[i] +
+          (((end[i] - start[i]) * t + kHalf) >> kFractionBits);
+    }
+  }
+
+  // Inserts a slot at index i, initialized with the given size.
+  void insert(int i, int size) {
+    for (auto* values : {&current_, &start_, &end_}) {
+      // From the last block so that the offsets of the earlier ones hold.
+      for (int field = kNumFields - 1; field >= 0; --field) {
+        values->insert(values->begin() + field * count_ + i,
+                       (field == kSize) ? size : 0);
+      }
+    }
+    minCenter_.insert(minCenter_.begin() + i, 0);
+    ++count_;
+  }
+
+  // Removes the slot at index i.
+  void erase(int i) {
+    for (auto* values : {&current_, &start_, &end_}) {
+      for (int field = kNumFields - 1; field >= 0; --field) {
+        values->erase(values->begin() + field * count_ + i);
+      }
+    }
+    minCenter_.erase(minCenter_.begin() + i);
+    --count_;
+  }
+
+  // Keeps only the first count slots.
+  void truncate(int count) {
+    if (count >= count_) {
+      return;
+    }
+    for (auto* values : {&current_, &start_, &end_}) {
+      for (int field = kNumFields - 1; field >= 0; --field) {
+        values->erase(values->begin() + field * count_ + count,
+                      values->begin() + (field + 1) * count_);
+      }
+    }
+    minCenter_.resize(count);
+    count_ = count;
+  }
+
+ private:
+  enum Field { kLeft, kTop, kSize, kNumFields };
+  enum BackgroundField { kWidth, kHeight, kNumBackgroundFields };
+
+  // For the fixed-point interpolation. The deltas are in pixels, so their
+  // products with a 16-bit fraction fit in 32 bits.
+  static constexpr int kFractionBits = 16;
+  static constexpr int32_t kHalf = 1 << (kFractionBits - 1);
+
+  int backgroundIndex(BackgroundField field) const {
+    return kNumFields * count_ + field;
+  }
+
+  int count_;
+  std::vector<int> current_;
+  std::vector<int> start_;
+  std::vector<int> end_;
+  std::vector<int> minCenter_;
+};
+
+}  // namespace ksmoothdock
+
+#endif  // KSMOOTHDOCK_DOCK_ITEM_GEOMETRY_H_
@@ -0,0 +1,186 @@
+/*
+ * This file is part of KSmoothDock.
+ * Copyright (C) 2017 Viet Dang (dangvd@gmail.com)
+ *
+ * KSmoothDock is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * KSmoothDock is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with KSmoothDock.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Micro-benchmark of one animation frame: the batched interpolation of
+// DockItemGeometry::setAnimationProgress() against the former per-item loop,
+// where each heap-allocated item interpolated its own fields.
+//
+// Usage: dock_item_geometry_bench [number of items]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "dock_item_geometry.h"
+
+namespace {
+
+constexpr int kNumSteps = 20;
+constexpr int kNumRounds = 20000;
+
+// The animation state as it was stored in each DockItem.
+struct LegacyItem {
+  int size;
+  int left;
+  int top;
+  int startLeft;
+  int startTop;
+  int startSize;
+  int endLeft;
+  int endTop;
+  int endSize;
+  int currentStep;
+  int numSteps;
+
+  void nextAnimationStep() {
+    ++currentStep;
+    if (currentStep <= numSteps) {
+      left = startLeft + (endLeft - startLeft) * currentStep / numSteps;
+      top = startTop + (endTop - startTop) * currentStep / numSteps;
+      size = startSize + (endSize - startSize) * currentStep / numSteps;
+    }
+  }
+};
+
+struct LegacyPanel {
+  std::vector<std::unique_ptr<LegacyItem>> items;
+  int backgroundWidth;
+  int startBackgroundWidth;
+  int endBackgroundWidth;
+  int backgroundHeight;
+  int startBackgroundHeight;
+  int endBackgroundHeight;
+  int currentStep;
+
+  void updateAnimation() {
+    for (const auto& item : items) {
+      item->nextAnimationStep();
+    }
+    ++currentStep;
+    backgroundWidth = startBackgroundWidth
+        + (endBackgroundWidth - startBackgroundWidth)
+            * currentStep / kNumSteps;
+    backgroundHeight = startBackgroundHeight
+        + (endBackgroundHeight - startBackgroundHeight)
+            * currentStep / kNumSteps;
+  }
+};
+
+using Clock = std::chrono::steady_clock;
+
+double nanosPerFrame(Clock::duration elapsed) {
+  return std::chrono::duration<double, std::nano>(elapsed).count()
+      / (kNumRounds * kNumSteps);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const int numItems = (argc > 1) ? std::atoi(argv[1]) : 50;
+  if (numItems <= 0) {
+    std::fprintf(stderr, "Invalid number of items: %s\n", argv[1]);
+    return 1;
+  }
+
+  std::mt19937 random(1);
+  std::uniform_int_distribution<int> position(0, 3840);
+  std::uniform_int_distribution<int> size(48, 128);
+
+  LegacyPanel legacy;
+  ksmoothdock::DockItemGeometry geometry;
+  for (int i = 0; i < numItems; ++i) {
+    auto item = std::make_unique<LegacyItem>();
+    item->startLeft = position(random);
+    item->startTop = position(random);
+    item->startSize = size(random);
+    item->endLeft = position(random);
+    item->endTop = position(random);
+    item->endSize = size(random);
+    item->numSteps = kNumSteps;
+
+    geometry.insert(i, item->startSize);
+    geometry.startLeft(i) = item->startLeft;
+    geometry.startTop(i) = item->startTop;
+    geometry.startSize(i) = item->startSize;
+    geometry.endLeft(i) = item->endLeft;
+    geometry.endTop(i) = item->endTop;
+    geometry.endSize(i) = item->endSize;
+    legacy.items.push_back(std::move(item));
+  }
+  legacy.startBackgroundWidth = geometry.startBackgroundWidth() = 1000;
+  legacy.endBackgroundWidth = geometry.endBackgroundWidth() = 3000;
+  legacy.startBackgroundHeight = geometry.startBackgroundHeight() = 1;
+  legacy.endBackgroundHeight = geometry.endBackgroundHeight() = 140;
+
+  // Both versions write every value of every frame, so the checksums keep
+  // the compiler from dropping the loops.
+  long long legacyChecksum = 0;
+  const auto legacyStart = Clock::now();
+  for (int round = 0; round < kNumRounds; ++round) {
+    legacy.currentStep = 0;
+    for (const auto& item : legacy.items) {
+      item->currentStep = 0;
+    }
+    for (int step = 1; step <= kNumSteps; ++step) {
+      legacy.updateAnimation();
+    }
+    legacyChecksum += legacy.items.back()->left + legacy.backgroundWidth;
+  }
+  const auto legacyElapsed = Clock::now() - legacyStart;
+
+  long long batchedChecksum = 0;
+  const auto batchedStart = Clock::now();
+  for (int round = 0; round < kNumRounds; ++round) {
+    geometry.startAnimation();
+    for (int step = 1; step <= kNumSteps; ++step) {
+      geometry.setAnimationProgress(static_cast<double>(step) / kNumSteps);
+    }
+    batchedChecksum +=
+        geometry.left(numItems - 1) + geometry.backgroundWidth();
+  }
+  const auto batchedElapsed = Clock::now() - batchedStart;
+
+  // The intermediate frames may differ by rounding but the last one must not.
+  int maxError = 0;
+  for (int step = 1; step <= kNumSteps; ++step) {
+    geometry.setAnimationProgress(static_cast<double>(step) / kNumSteps);
+    for (int i = 0; i < numItems; ++i) {
+      const auto& item = legacy.items[i];
+      const int expected = item->startLeft
+          + (item->endLeft - item->startLeft) * step / kNumSteps;
+      maxError = std::max(maxError, std::abs(geometry.left(i) - expected));
+    }
+  }
+
+  std::printf("items: %d\n", numItems);
+  std::printf("per-item loop: %.1f ns/frame\n",
+              nanosPerFrame(legacyElapsed));
+  std::printf("batched kernel: %.1f ns/frame\n",
+              nanosPerFrame(batchedElapsed));
+  std::printf("max intermediate difference: %d px\n", maxError);
+  if (legacyChecksum != batchedChecksum) {
+    std::fprintf(stderr, "Last frames differ: %lld vs %lld\n", legacyChecksum,
+                 batchedChecksum);
+    return 1;
+  }
+  return 0;
+}
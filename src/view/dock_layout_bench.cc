@@ -0,0 +1,236 @@
+/*
+ * This file is part of KSmoothDock.
+ * Copyright (C) 2017 Viet Dang (dangvd@gmail.com)
+ *
+ * KSmoothDock is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * KSmoothDock is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with KSmoothDock.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Benchmark of the zoom/layout engine of DockPanel.
+//
+// Builds a dock with 10, 100 and 1000 synthetic items in each position, then
+// sweeps the mouse through updateLayout(x, y), updateAnimation() and
+// findActiveItem(). Prints the time and the number of heap allocations per
+// event as JSON on stdout.
+//
+// Usage: dock_layout_bench [number of events per benchmark]
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <memory>
+#include <new>
+
+#include <QApplication>
+#include <QTemporaryDir>
+
+#include "dock_panel.h"
+#include "iconless_dock_item.h"
+#include "multi_dock_view.h"
+
+namespace {
+
+std::atomic<long long> allocationCount(0);
+
+}  // namespace
+
+// Counts the heap allocations of the whole program.
+void* operator new(std::size_t size) {
+  ++allocationCount;
+  if (void* p = std::malloc(size == 0 ? 1 : size)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+  return operator new(size);
+}
+
+void operator delete(void* p) noexcept {
+  std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+  std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+  std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+  std::free(p);
+}
+
+namespace ksmoothdock {
+
+constexpr int kDockId = 1;
+
+// A square item that doesn't draw anything.
+class SyntheticItem : public IconlessDockItem {
+ public:
+  SyntheticItem(DockPanel* parent, Qt::Orientation orientation, int minSize,
+                int maxSize)
+      : IconlessDockItem(parent, "", orientation, minSize, maxSize,
+                         /*whRatio=*/1.0) {}
+
+  void draw(QPainter* painter) const override {}
+  void mousePressEvent(QMouseEvent* e) override {}
+};
+
+class DockLayoutBench {
+ public:
+  explicit DockLayoutBench(int numEvents)
+      : model_(configDir_.path()), numEvents_(numEvents), isFirst_(true) {
+    model_.addDock();
+    view_ = std::make_unique<MultiDockView>(&model_);
+    dock_ = std::make_unique<DockPanel>(view_.get(), &model_, kDockId);
+  }
+
+  void run() {
+    std::printf("{\n  \"benchmarks\": [");
+    for (const auto position : {PanelPosition::Top, PanelPosition::Bottom,
+                                PanelPosition::Left, PanelPosition::Right}) {
+      for (const int numItems : {10, 100, 1000}) {
+        setUp(position, numItems);
+        benchmarkUpdateLayout(position, numItems);
+        benchmarkUpdateAnimation(position, numItems);
+        benchmarkFindActiveItem(position, numItems);
+      }
+    }
+    std::printf("\n  ]\n}\n");
+  }
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  // Replaces the items of the dock with synthetic ones.
+  void setUp(PanelPosition position, int numItems) {
+    dock_->setPosition(position);
+    dock_->truncateItems(0);
+    for (int i = 0; i < numItems; ++i) {
+      dock_->appendItem(std::make_unique<SyntheticItem>(
+          dock_.get(), dock_->orientation_, dock_->minSize_, dock_->maxSize_));
+    }
+    dock_->initLayoutVars();
+    dock_->updateLayout();
+  }
+
+  // Gets the mouse position of the specified event of a sweep along the
+  // zoomed dock.
+  QPoint mousePosition(int event) {
+    const int length = dock_->isHorizontal() ? dock_->maxWidth_
+                                             : dock_->maxHeight_;
+    const int position = static_cast<int>(
+        static_cast<long long>(length) * event / numEvents_);
+    return dock_->isHorizontal() ? QPoint(position, dock_->maxHeight_ / 2)
+                                 : QPoint(dock_->maxWidth_ / 2, position);
+  }
+
+  void benchmarkUpdateLayout(PanelPosition position, int numItems) {
+    // Zooms in first so that the sweep measures the steady state.
+    const QPoint start = mousePosition(0);
+    dock_->updateLayout(start.x(), start.y());
+
+    const auto allocations = allocationCount.load();
+    const auto startTime = Clock::now();
+    for (int event = 0; event < numEvents_; ++event) {
+      const QPoint mouse = mousePosition(event);
+      dock_->updateLayout(mouse.x(), mouse.y());
+    }
+    report("updateLayout", position, numItems, Clock::now() - startTime,
+           allocationCount.load() - allocations);
+  }
+
+  void benchmarkUpdateAnimation(PanelPosition position, int numItems) {
+    // Starts an entering animation long enough that every call is a frame.
+    const int animationDuration = dock_->animationDuration_;
+    dock_->animationDuration_ = std::numeric_limits<int>::max();
+    dock_->updateLayout();
+    dock_->isEntering_ = true;
+    const QPoint mouse = mousePosition(numEvents_ / 2);
+    dock_->updateLayout(mouse.x(), mouse.y());
+    dock_->animationTimer_->stop();
+
+    const auto allocations = allocationCount.load();
+    const auto startTime = Clock::now();
+    for (int event = 0; event < numEvents_; ++event) {
+      dock_->updateAnimation();
+    }
+    report("updateAnimation", position, numItems, Clock::now() - startTime,
+           allocationCount.load() - allocations);
+
+    dock_->animationDuration_ = animationDuration;
+    dock_->isAnimationActive_ = false;
+  }
+
+  void benchmarkFindActiveItem(PanelPosition position, int numItems) {
+    const QPoint start = mousePosition(0);
+    dock_->updateLayout(start.x(), start.y());
+
+    long long checksum = 0;
+    const auto allocations = allocationCount.load();
+    const auto startTime = Clock::now();
+    for (int event = 0; event < numEvents_; ++event) {
+      const QPoint mouse = mousePosition(event);
+      checksum += dock_->findActiveItem(mouse.x(), mouse.y());
+    }
+    report("findActiveItem", position, numItems, Clock::now() - startTime,
+           allocationCount.load() - allocations);
+    // Keeps the loop from being optimized away.
+    if (checksum == std::numeric_limits<long long>::min()) {
+      std::fprintf(stderr, "%lld\n", checksum);
+    }
+  }
+
+  void report(const char* name, PanelPosition position, int numItems,
+              Clock::duration elapsed, long long allocations) {
+    static constexpr const char* kPositionNames[] =
+        {"top", "bottom", "left", "right"};
+    const double nanos =
+        std::chrono::duration<double, std::nano>(elapsed).count();
+    std::printf("%s\n    {\"name\": \"%s\", \"position\": \"%s\", "
+                "\"items\": %d, \"events\": %d, \"ns_per_event\": %.1f, "
+                "\"allocations_per_event\": %.3f}",
+                isFirst_ ? "" : ",", name,
+                kPositionNames[static_cast<int>(position)], numItems,
+                numEvents_, nanos / numEvents_,
+                static_cast<double>(allocations) / numEvents_);
+    isFirst_ = false;
+  }
+
+  QTemporaryDir configDir_;
+  MultiDockModel model_;
+  std::unique_ptr<MultiDockView> view_;
+  std::unique_ptr<DockPanel> dock_;
+  int numEvents_;
+  bool isFirst_;
+};
+
+}  // namespace ksmoothdock
+
+int main(int argc, char** argv) {
+  QApplication app(argc, argv);
+  const int numEvents = (argc > 1) ? std::atoi(argv[1]) : 2000;
+  if (numEvents <= 0) {
+    std::fprintf(stderr, "Invalid number of events: %s\n", argv[1]);
+    return 1;
+  }
+
+  ksmoothdock::DockLayoutBench bench(numEvents);
+  bench.run();
+  return 0;
+}
@@ -25,20 +25,27 @@
 #include <qfont.h>
 #include <qfontdatabase.h>
 #include <qnamespace.h>
+#include <unordered_set>
 #include <utility>
 
 #include <QColor>
 #include <QCursor>
+#include <QDebug>
+#include <QDir>
 #include <QGuiApplication>
 #include <QIcon>
 #include <QListWidgetItem>
 #include <QPainter>
 #include <QProcess>
+#include <QSaveFile>
 #include <QScreen>
 #include <QSize>
+#include <QStandardPaths>
 #include <QStringList>
 #include <QVariant>
+#include <QWindow>
 #include <Qt>
+#include <typeinfo>
 
 #include <KAboutData>
 #include <KLocalizedString>
@@ -57,8 +64,26 @@
 
 namespace ksmoothdock {
 
+namespace {
+
+// Gets the rectangle to draw an icon in: the icon scaled to fit the item, and
+// centered if its aspect ratio is different from the item's.
+QRect getIconRect(const DockItem& item, const QPixmap& icon) {
+  const QSize size = (QSizeF(icon.size()) / icon.devicePixelRatioF())
+      .scaled(item.getWidth(), item.getHeight(), Qt::KeepAspectRatio)
+      .toSize();
+  return QRect(item.left() + (item.getWidth() - size.width()) / 2,
+               item.top() + (item.getHeight() - size.height()) / 2,
+               size.width(), size.height());
+}
+
+}  // namespace
+
 const int DockPanel::kTooltipSpacing;
 const int DockPanel::kAutoHideSize;
+const int DockPanel::kMaxIconAtlasArea;
+const int DockPanel::kIconAtlasPadding;
+const int DockPanel::kDefaultAnimationFrameIntervalMs;
 
 DockPanel::DockPanel(MultiDockView* parent, MultiDockModel* model, int dockId)
     : QWidget(),
@@ -69,6 +94,13 @@ DockPanel::DockPanel(MultiDockView* parent, MultiDockModel* model, int dockId)
       showPager_(false),
       showClock_(false),
       showBorder_(true),
+      zoomFirst_(1),
+      zoomLast_(0),
+      isZoomWindowValid_(false),
+      iconAtlasColumns_(1),
+      isIconAtlasValid_(false),
+      iconAtlasDevicePixelRatio_(0),
+      paintProfiler_(PaintProfiler::createIfEnabled()),
       aboutDialog_(KAboutData::applicationData(), this),
       addPanelDialog_(this, model, dockId),
       appearanceSettingsDialog_(this, model),
@@ -76,12 +108,15 @@ DockPanel::DockPanel(MultiDockView* parent, MultiDockModel* model, int dockId)
       applicationMenuSettingsDialog_(this, model),
       wallpaperSettingsDialog_(this, model),
       taskManagerSettingsDialog_(this, model),
+      taskHelper_(parent->taskHelper()),
       isMinimized_(true),
       isResizing_(false),
       isEntering_(false),
       isLeaving_(false),
       isAnimationActive_(false),
-      animationTimer_(std::make_unique<QTimer>(this)) {
+      animationTimer_(std::make_unique<QTimer>(this)),
+      mouseMoveTimer_(std::make_unique<QTimer>(this)),
+      hasPendingMouseMove_(false) {
   setAttribute(Qt::WA_TranslucentBackground);
   KWindowSystem::setType(winId(), NET::Dock);
   KWindowSystem::setOnAllDesktops(winId(), true);
@@ -93,22 +128,24 @@ DockPanel::DockPanel(MultiDockView* parent, MultiDockModel* model, int dockId)
 
   connect(animationTimer_.get(), SIGNAL(timeout()), this,
       SLOT(updateAnimation()));
+  mouseMoveTimer_->setSingleShot(true);
+  mouseMoveTimer_->setTimerType(Qt::PreciseTimer);
+  connect(mouseMoveTimer_.get(), SIGNAL(timeout()), this,
+      SLOT(updateLayoutForMouseMove()));
   connect(KWindowSystem::self(), SIGNAL(numberOfDesktopsChanged(int)),
       this, SLOT(updatePager()));
-  connect(KWindowSystem::self(), SIGNAL(currentDesktopChanged(int)),
-          this, SLOT(onCurrentDesktopChanged()));
   connect(KWindowSystem::self(), SIGNAL(activeWindowChanged(WId)),
           this, SLOT(update()));
-  connect(KWindowSystem::self(), SIGNAL(windowAdded(WId)),
-          this, SLOT(onWindowAdded(WId)));
-  connect(KWindowSystem::self(), SIGNAL(windowRemoved(WId)),
-          this, SLOT(onWindowRemoved(WId)));
-  connect(KWindowSystem::self(),
-          SIGNAL(windowChanged(WId, NET::Properties, NET::Properties2)),
-          this,
-          SLOT(onWindowChanged(WId, NET::Properties, NET::Properties2)));
-  connect(&activityManager_, &KActivities::Consumer::currentActivityChanged,
+  connect(taskHelper_, &TaskHelper::currentDesktopChanged,
+          this, &DockPanel::onCurrentDesktopChanged);
+  connect(taskHelper_, &TaskHelper::currentActivityChanged,
           this, &DockPanel::onCurrentActivityChanged);
+  connect(taskHelper_, &TaskHelper::taskAdded, this, &DockPanel::onTaskAdded);
+  connect(taskHelper_, &TaskHelper::taskMoved, this, &DockPanel::onTaskMoved);
+  connect(taskHelper_, &TaskHelper::taskRemoved,
+          this, &DockPanel::onTaskRemoved);
+  connect(taskHelper_, &TaskHelper::taskChanged,
+          this, &DockPanel::onTaskChanged);
   connect(model_, SIGNAL(appearanceOutdated()), this, SLOT(update()));
   connect(model_, SIGNAL(appearanceChanged()), this, SLOT(reload()));
   connect(model_, SIGNAL(dockLaunchersChanged(int)),
@@ -117,7 +154,38 @@ DockPanel::DockPanel(MultiDockView* parent, MultiDockModel* model, int dockId)
 
 void DockPanel::resize(int w, int h) {
   isResizing_ = true;
-  QWidget::resize(w, h);
+  const QPoint position = windowPosition(w, h);
+  if (w == minWidth_ && h == minHeight_) {
+    minX_ = position.x();
+    minY_ = position.y();
+  }
+  if (fixedSizeWindow_) {
+    // The window keeps its zoomed size and position, only its shape changes,
+    // so that zooming doesn't involve the window manager.
+    const QPoint maxPosition = windowPosition(maxWidth_, maxHeight_);
+    if (size() != QSize(maxWidth_, maxHeight_) || pos() != maxPosition) {
+      QWidget::resize(maxWidth_, maxHeight_);
+      move(maxPosition);
+      KWindowSystem::setOnAllDesktops(winId(), true);
+    }
+    setMask(QRegion(QRect(position - maxPosition, QSize(w, h))));
+  } else {
+    QWidget::resize(w, h);
+    if (isMinimized_) {
+      move(position);
+    }
+    if (!mask().isEmpty()) {
+      clearMask();
+    }
+    // This is to fix the bug that if launched from Plasma Quicklaunch,
+    // KSmoothDock still doesn't show on all desktops even though
+    // we've already called this in the constructor.
+    KWindowSystem::setOnAllDesktops(winId(), true);
+  }
+  isResizing_ = false;
+}
+
+QPoint DockPanel::windowPosition(int w, int h) {
   int x, y;
   if (position_ == PanelPosition::Top) {
     x = (screenGeometry_.width() - w) / 2;
@@ -132,18 +200,11 @@ void DockPanel::resize(int w, int h) {
     x = screenGeometry_.width() - w;
     y = (screenGeometry_.height() - h) / 2;
   }
-  if (isMinimized_) {
-    move(x + screenGeometry_.x(), y + screenGeometry_.y());
-  }
-  if (w == minWidth_ && h == minHeight_) {
-    minX_ = x + screenGeometry_.x();
-    minY_ = y + screenGeometry_.y();
-  }
-  // This is to fix the bug that if launched from Plasma Quicklaunch,
-  // KSmoothDock still doesn't show on all desktops even though
-  // we've already called this in the constructor.
-  KWindowSystem::setOnAllDesktops(winId(), true);
-  isResizing_ = false;
+  return QPoint(x + screenGeometry_.x(), y + screenGeometry_.y());
+}
+
+QPoint DockPanel::minimizedOffset() {
+  return hasMinimizedMask() ? QPoint(minX_, minY_) - pos() : QPoint(0, 0);
 }
 
 QPoint DockPanel::applicationMenuPosition(const QSize& menuSize) {
@@ -176,7 +237,7 @@ QPoint DockPanel::applicationSubMenuPosition(
 
 void DockPanel::reload() {
   loadAppearanceConfig();
-  items_.clear();
+  truncateItems(0);
   initUi();
   update();
 }
@@ -184,7 +245,7 @@ void DockPanel::reload() {
 void DockPanel::refresh() {
   for (int i = 0; i < itemCount(); ++i) {
     if (items_[i]->shouldBeRemoved()) {
-      items_.erase(items_.begin() + i);
+      removeItem(i);
       resizeTaskManager();
       return;
     }
@@ -246,17 +307,21 @@ void DockPanel::setScreen(int screen) {
 }
 
 void DockPanel::updateAnimation() {
-  for (const auto& item : items_) {
-    item->nextAnimationStep();
-  }
-  ++currentAnimationStep_;
-  backgroundWidth_ = startBackgroundWidth_
-      + (endBackgroundWidth_ - startBackgroundWidth_)
-          * currentAnimationStep_ / numAnimationSteps_;
-  backgroundHeight_ = startBackgroundHeight_
-      + (endBackgroundHeight_ - startBackgroundHeight_)
-          * currentAnimationStep_ / numAnimationSteps_;
-  if (currentAnimationStep_ == numAnimationSteps_) {
+  // Repaints the old and the new bounds of the items and the background.
+  QRegion damage(itemsDirtyRect(0, itemCount() - 1));
+  damage += backgroundRect();
+
+  // Late frames are simply dropped: the next frame catches up to the time.
+  const qint64 elapsed = animationClock_.elapsed();
+  const bool isLastFrame = elapsed >= animationDuration_;
+  {
+    PaintTimer timer(paintProfiler_.get(), PaintProfiler::kLayout);
+    itemGeometry_.setAnimationProgress(
+        isLastFrame ? 1.0
+                    : animationEasingCurve_.valueForProgress(
+                          static_cast<qreal>(elapsed) / animationDuration_));
+  }
+  if (isLastFrame) {
     animationTimer_->stop();
     isAnimationActive_ = false;
     if (isLeaving_) {
@@ -266,7 +331,17 @@ void DockPanel::updateAnimation() {
       showTooltip(mouseX_, mouseY_);
     }
   }
-  repaint();
+  damage += itemsDirtyRect(0, itemCount() - 1);
+  damage += backgroundRect();
+  if (paintProfiler_ == nullptr) {
+    repaint(damage);
+    return;
+  }
+
+  QElapsedTimer timer;
+  timer.start();
+  repaint(damage);
+  paintProfiler_->endFrame(timer.nsecsElapsed());
 }
 
 void DockPanel::resetCursor() {
@@ -343,48 +418,62 @@ void DockPanel::removeDock() {
   }
 }
 
-void DockPanel::onWindowAdded(WId wId) {
+void DockPanel::onTaskAdded(const TaskInfo& task, int screen,
+                            bool onCurrentDesktop) {
   if (!showTaskManager()) {
     return;
   }
 
-  if (taskHelper_.isValidTask(wId, screen_)) {
+  if (isTaskShown(screen, onCurrentDesktop)) {
     // Now inserts it.
-    addTask(wId);
+    addTask(task);
     resizeTaskManager();
   }
 }
 
-void DockPanel::onWindowRemoved(WId wId) {
+void DockPanel::onTaskMoved(const TaskInfo& task, int screen,
+                            bool onCurrentDesktop) {
   if (!showTaskManager()) {
     return;
   }
 
-  removeTask(wId);
+  if (isTaskShown(screen, onCurrentDesktop)) {
+    addTask(task);
+    resizeTaskManager();
+  } else if (removeTask(task.wId)) {
+    resizeTaskManager();
+  }
 }
 
-void DockPanel::onWindowChanged(WId wId, NET::Properties properties,
-                                NET::Properties2 properties2) {
+void DockPanel::onTaskRemoved(WId wId) {
   if (!showTaskManager()) {
     return;
   }
 
-  if (wId != winId() && wId != tooltip_.winId() &&
-      taskHelper_.isValidTask(wId)) {
-    auto screen = model_->currentScreenTasksOnly() ? screen_ : -1;
+  if (removeTask(wId)) {
+    resizeTaskManager();
+  }
+}
 
-    if (properties & NET::WMDesktop || properties & NET::WMGeometry) {
-      if (taskHelper_.isValidTask(wId, screen, model_->currentDesktopTasksOnly())) {
-        addTask(wId);
-        resizeTaskManager();
-      } else {
-        removeTask(wId);
-      }
-    } else if ((properties & NET::WMState) || (properties & NET::WMName) || (properties & NET::WMIconName) ||
-               (properties & NET::WMVisibleName) || (properties & NET::WMVisibleIconName)) {
-      updateTask(wId);
-    }
+void DockPanel::onTaskChanged(const TaskInfo& task) {
+  if (!showTaskManager()) {
+    return;
   }
+
+  updateTask(task);
+}
+
+bool DockPanel::event(QEvent* e) {
+  if (paintProfiler_ == nullptr || e->type() != QEvent::UpdateRequest) {
+    return QWidget::event(e);
+  }
+
+  // The update request paints and flushes the dirty region.
+  QElapsedTimer timer;
+  timer.start();
+  const bool result = QWidget::event(e);
+  paintProfiler_->endFrame(timer.nsecsElapsed());
+  return result;
 }
 
 void DockPanel::paintEvent(QPaintEvent* e) {
@@ -392,47 +481,193 @@ void DockPanel::paintEvent(QPaintEvent* e) {
     return;  // to avoid potential flicker.
   }
 
+  PaintTimer paintTimer(paintProfiler_.get(), PaintProfiler::kPaint);
   QPainter painter(this);
+  const QPoint offset = minimizedOffset();
+  painter.translate(offset);
 
-  if (isHorizontal()) {
-    const int y = (position_ == PanelPosition::Top)
-                  ? 0 : height() - backgroundHeight_;
-    painter.fillRect((width() - backgroundWidth_) / 2, y,
-                     backgroundWidth_, backgroundHeight_, backgroundColor_);
-
+  {
+    PaintTimer timer(paintProfiler_.get(), PaintProfiler::kBackground);
+    const QRect background = backgroundRect();
+    painter.fillRect(background, backgroundColor_);
     if (showBorder_) {
       painter.setPen(borderColor_);
-      painter.drawRect((width() - backgroundWidth_) / 2, y,
-                       backgroundWidth_ - 1, backgroundHeight_ - 1);
+      painter.drawRect(background.adjusted(0, 0, -1, -1));
     }
-  } else {  // Vertical
-    const int x =  (position_ == PanelPosition::Left)
-                   ? 0 : width() - backgroundWidth_;
-    painter.fillRect(x, (height() - backgroundHeight_) / 2,
-                     backgroundWidth_, backgroundHeight_, backgroundColor_);
+  }
 
-    if (showBorder_) {
-      painter.setPen(borderColor_);
-      painter.drawRect(x, (height() - backgroundHeight_) / 2,
-                       backgroundWidth_ - 1, backgroundHeight_ - 1);
+  // The painter is clipped to the region to repaint so only the items that
+  // may paint in that region are drawn. They are drawn in three passes, the
+  // highlights, the icons and the rest, so that the painter's state changes
+  // per pass rather than per item.
+  const QRegion region = e->region().translated(-offset);
+  paintedItems_.clear();
+  for (int i = itemCount() - 1; i >= 0; --i) {
+    if (region.intersects(itemsDirtyRect(i, i))) {
+      paintedItems_.push_back(i);
     }
   }
 
-  // Draw the items from the end to avoid zoomed items getting clipped by
-  // non-zoomed items.
-  for (int i = itemCount() - 1; i >= 0; --i) {
-    items_[i]->draw(&painter);
+  {
+    PaintTimer timer(paintProfiler_.get(), PaintProfiler::kHighlights);
+    for (const int i : paintedItems_) {
+      items_[i]->drawHighlight(&painter);
+    }
+  }
+  {
+    PaintTimer timer(paintProfiler_.get(), PaintProfiler::kIcons);
+    drawIcons(&painter);
+  }
+  for (const int i : paintedItems_) {
+    const DockItem& item = *items_[i];
+    // Timed per item class.
+    PaintTimer timer(paintProfiler_.get(),
+                     paintProfiler_ ? typeid(item).name() : nullptr);
+    item.draw(&painter);
+  }
+}
+
+void DockPanel::dumpPaintProfile() {
+  const QString report = "Paint profile of panel " + QString::number(dockId_)
+      + ":\n" + paintProfiler_->report();
+  qInfo().noquote() << report;
+  // In the user's own cache dir rather than the shared temp dir, where the
+  // file could be a link planted by another user.
+  const QString dir =
+      QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+  const QString path = QDir(dir).filePath(
+      "paint_profile_" + QString::number(dockId_) + ".txt");
+  QSaveFile file(path);
+  if (!QDir().mkpath(dir) || !file.open(QIODevice::WriteOnly | QIODevice::Text)
+      || file.write(report.toUtf8()) < 0 || !file.commit()) {
+    qWarning() << "Failed to write the paint profile to" << path;
+    return;
+  }
+  qInfo() << "Written to" << path;
+}
+
+void DockPanel::updateItem(const DockItem* item) {
+  if (item->slot_ < 0) {
+    return;
+  }
+  update(itemsDirtyRect(item->slot_, item->slot_)
+             .translated(minimizedOffset()));
+}
+
+void DockPanel::drawIcons(QPainter* painter) {
+  const bool hasIconAtlas = updateIconAtlas();
+  iconFragments_.clear();
+  iconAtlasUpdates_.clear();
+  // The icons are drawn scaled down to the item sizes between the levels.
+  painter->setRenderHint(QPainter::SmoothPixmapTransform);
+  for (const int i : paintedItems_) {
+    const auto& item = items_[i];
+    const QPixmap* icon = item->getCurrentIcon();
+    if (icon == nullptr) {
+      continue;
+    }
+
+    const QRect rect = getIconRect(*item, *icon);
+    const qint64 key = icon->cacheKey();
+    if (hasIconAtlas && iconAtlasKeys_[i] == key) {
+      // The atlas is in device pixels.
+      const QRect slot = iconAtlasSlot(i);
+      iconFragments_.push_back(QPainter::PixmapFragment::create(
+          QRectF(rect).center(),
+          QRectF(slot.x(), slot.y(), icon->width(), icon->height()),
+          static_cast<qreal>(rect.width()) / icon->width(),
+          static_cast<qreal>(rect.height()) / icon->height()));
+    } else {
+      painter->drawPixmap(rect, *icon);
+      if (hasIconAtlas && lastIconKeys_[i] == key) {
+        iconAtlasUpdates_.push_back(i);
+      }
+    }
+    if (hasIconAtlas) {
+      lastIconKeys_[i] = key;
+    }
+  }
+
+  if (!iconFragments_.empty()) {
+    painter->drawPixmapFragments(iconFragments_.data(),
+                                 static_cast<int>(iconFragments_.size()),
+                                 iconAtlas_);
+  }
+  copyIconsToAtlas();
+}
+
+bool DockPanel::updateIconAtlas() {
+  const qreal devicePixelRatio = devicePixelRatioF();
+  if (isIconAtlasValid_ && iconAtlasDevicePixelRatio_ == devicePixelRatio) {
+    return !iconAtlas_.isNull();
+  }
+  isIconAtlasValid_ = true;
+  iconAtlasDevicePixelRatio_ = devicePixelRatio;
+
+  QSize slotSize(0, 0);
+  for (const auto& item : items_) {
+    slotSize = slotSize.expandedTo(QSize(
+        static_cast<int>(std::ceil(item->getMaxWidth() * devicePixelRatio)),
+        static_cast<int>(std::ceil(item->getMaxHeight() * devicePixelRatio))));
+  }
+  const int count = itemCount();
+  const int columns =
+      std::max(static_cast<int>(std::ceil(std::sqrt(count))), 1);
+  const int rows = (count + columns - 1) / columns;
+  const QSize atlasSize(columns * (slotSize.width() + 2 * kIconAtlasPadding),
+                        rows * (slotSize.height() + 2 * kIconAtlasPadding));
+  if (slotSize.isEmpty() || static_cast<long long>(atlasSize.width())
+      * atlasSize.height() > kMaxIconAtlasArea) {
+    iconAtlas_ = QPixmap();
+    iconAtlasKeys_.clear();
+    lastIconKeys_.clear();
+    return false;
+  }
+
+  if (iconAtlas_.size() != atlasSize || iconAtlasSlotSize_ != slotSize
+      || static_cast<int>(iconAtlasKeys_.size()) != count) {
+    iconAtlas_ = QPixmap(atlasSize);
+    iconAtlas_.fill(Qt::transparent);
+    iconAtlasSlotSize_ = slotSize;
+    iconAtlasColumns_ = columns;
+    iconAtlasKeys_.assign(count, 0);
+    lastIconKeys_.assign(count, 0);
+  }
+  return true;
+}
+
+void DockPanel::copyIconsToAtlas() {
+  QPainter atlasPainter;
+  for (const int i : iconAtlasUpdates_) {
+    const QPixmap* icon = items_[i]->getCurrentIcon();
+    if (icon == nullptr || icon->width() > iconAtlasSlotSize_.width()
+        || icon->height() > iconAtlasSlotSize_.height()) {
+      continue;
+    }
+
+    if (!atlasPainter.isActive()) {
+      atlasPainter.begin(&iconAtlas_);
+      atlasPainter.setCompositionMode(QPainter::CompositionMode_Source);
+    }
+    const QRect slot = iconAtlasSlot(i);
+    atlasPainter.fillRect(slot, Qt::transparent);
+    // In device pixels, regardless of the icon's device pixel ratio.
+    atlasPainter.drawPixmap(QRect(slot.topLeft(), icon->size()), *icon);
+    iconAtlasKeys_[i] = icon->cacheKey();
   }
 }
 
 void DockPanel::mouseMoveEvent(QMouseEvent* e) {
+  const QPoint mouse = e->pos() - minimizedOffset();
   if (isEntering_ && !autoHide()) {
     // Don't do the parabolic zooming if the mouse is near the border.
     // Quite often the user was just scrolling a window etc.
-    if ((position_ == PanelPosition::Bottom && e->y() < itemSpacing_ / 2) ||
-        (position_ == PanelPosition::Top && e->y() > height() - itemSpacing_ / 2) ||
-        (position_ == PanelPosition::Left && e->x() > width() - itemSpacing_ / 2) ||
-        (position_ == PanelPosition::Right && e->x() < itemSpacing_ / 2)) {
+    if ((position_ == PanelPosition::Bottom && mouse.y() < itemSpacing_ / 2) ||
+        (position_ == PanelPosition::Top &&
+            mouse.y() > panelHeight() - itemSpacing_ / 2) ||
+        (position_ == PanelPosition::Left &&
+            mouse.x() > panelWidth() - itemSpacing_ / 2) ||
+        (position_ == PanelPosition::Right && mouse.x() < itemSpacing_ / 2)) {
       return;
     }
   }
@@ -441,10 +676,27 @@ void DockPanel::mouseMoveEvent(QMouseEvent* e) {
     return;
   }
 
+  pendingMouseX_ = mouse.x();
+  pendingMouseY_ = mouse.y();
+  hasPendingMouseMove_ = true;
+  // If the dock has already been laid out in this frame, the latest position
+  // will be laid out when the frame ends.
+  if (!mouseMoveTimer_->isActive()) {
+    updateLayoutForMouseMove();
+  }
+}
+
+void DockPanel::updateLayoutForMouseMove() {
+  if (!hasPendingMouseMove_ || isAnimationActive_) {
+    return;
+  }
+
+  hasPendingMouseMove_ = false;
   if (!isEntering_) {
-    showTooltip(e->x(), e->y());
+    showTooltip(pendingMouseX_, pendingMouseY_);
   }
-  updateLayout(e->x(), e->y());
+  updateLayout(pendingMouseX_, pendingMouseY_);
+  mouseMoveTimer_->start();
 }
 
 void DockPanel::mousePressEvent(QMouseEvent* e) {
@@ -452,7 +704,8 @@ void DockPanel::mousePressEvent(QMouseEvent* e) {
     return;
   }
 
-  int i = findActiveItem(e->x(), e->y());
+  const QPoint mouse = e->pos() - minimizedOffset();
+  int i = findActiveItem(mouse.x(), mouse.y());
   if (i < 0 || i >= itemCount()) {
     return;
   }
@@ -476,6 +729,8 @@ void DockPanel::leaveEvent(QEvent* e) {
     return;
   }
 
+  hasPendingMouseMove_ = false;
+  mouseMoveTimer_->stop();
   isLeaving_ = true;
   updateLayout();
   tooltip_.hide();
@@ -583,6 +838,10 @@ void DockPanel::createMenu() {
                   this, SLOT(showOnlineDocumentation()));
   menu_.addAction(QIcon::fromTheme("help-about"), i18n("A&bout KSmoothDock"),
       this, SLOT(about()));
+  if (paintProfiler_ != nullptr) {
+    menu_.addAction(i18n("Dump &Paint Profile"), this,
+                    SLOT(dumpPaintProfile()));
+  }
   menu_.addSeparator();
   menu_.addAction(i18n("E&xit"), parent_, SLOT(exit()));
 }
@@ -658,15 +917,35 @@ void DockPanel::loadAppearanceConfig() {
   minSize_ = model_->minIconSize();
   maxSize_ = model_->maxIconSize();
   spacingFactor_ = model_->spacingFactor();
+  zoomCurve_ = model_->zoomCurve();
+  zoomUpdateRate_ = std::max(model_->zoomUpdateRate(), 1);
+  mouseMoveTimer_->setInterval(1000 / zoomUpdateRate_);
+  animationDuration_ = std::max(model_->animationDuration(), 0);
+  switch (model_->animationCurve()) {
+    case AnimationCurve::OutQuad:
+      animationEasingCurve_.setType(QEasingCurve::OutQuad);
+      break;
+    case AnimationCurve::InOutQuad:
+      animationEasingCurve_.setType(QEasingCurve::InOutQuad);
+      break;
+    case AnimationCurve::OutCubic:
+      animationEasingCurve_.setType(QEasingCurve::OutCubic);
+      break;
+    case AnimationCurve::Linear:  // fall through
+    default:
+      animationEasingCurve_.setType(QEasingCurve::Linear);
+      break;
+  }
   backgroundColor_ = model_->backgroundColor();
   showBorder_ = model_->showBorder();
   borderColor_ = model_->borderColor();
   tooltipFontSize_ = model_->tooltipFontSize();
+  fixedSizeWindow_ = model_->fixedSizeWindow();
 }
 
 void DockPanel::initApplicationMenu() {
   if (showApplicationMenu_) {
-    items_.push_back(std::make_unique<ApplicationMenu>(
+    appendItem(std::make_unique<ApplicationMenu>(
         this, model_, orientation_, minSize_, maxSize_));
   }
 }
@@ -674,9 +953,9 @@ void DockPanel::initApplicationMenu() {
 void DockPanel::initLaunchers() {
   for (const auto& launcherConfig : model_->dockLauncherConfigs(dockId_)) {
     if (launcherConfig.command == "SEPARATOR") {
-      items_.push_back(std::make_unique<Separator>(this, model_, orientation_, minSize_, maxSize_));
+      appendItem(std::make_unique<Separator>(this, model_, orientation_, minSize_, maxSize_));
     } else {
-      items_.push_back(std::make_unique<Program>(
+      appendItem(std::make_unique<Program>(
           this, model_, launcherConfig.name, orientation_, launcherConfig.icon, minSize_,
           maxSize_, launcherConfig.command, launcherConfig.taskCommand, /*pinned=*/true));
     }
@@ -687,7 +966,7 @@ void DockPanel::initPager() {
   if (showPager_) {
     for (int desktop = 1; desktop <= KWindowSystem::numberOfDesktops();
          ++desktop) {
-      items_.push_back(std::make_unique<DesktopSelector>(
+      appendItem(std::make_unique<DesktopSelector>(
           this, model_, orientation_, minSize_, maxSize_, desktop, screen_));
     }
   }
@@ -699,7 +978,7 @@ void DockPanel::initTasks() {
   }
 
   auto screen = model_->currentScreenTasksOnly() ? screen_ : -1;
-  for (const auto& task : taskHelper_.loadTasks(screen, model_->currentDesktopTasksOnly())) {
+  for (const auto& task : taskHelper_->loadTasks(screen, model_->currentDesktopTasksOnly())) {
     addTask(task);
   }
 }
@@ -709,77 +988,187 @@ void DockPanel::reloadTasks() {
     return;
   }
 
-  const int itemsToKeep = applicationMenuItemCount() + pagerItemCount();
-  items_.resize(itemsToKeep);
-  initLaunchers();
-  initTasks();
-  initClock();
+  auto screen = model_->currentScreenTasksOnly() ? screen_ : -1;
+  updateTasks(taskHelper_->loadTasks(screen,
+                                     model_->currentDesktopTasksOnly()));
+}
+
+void DockPanel::updateTasks(const std::vector<TaskInfo>& tasks) {
+  std::unordered_set<WId> newTasks;
+  for (const auto& task : tasks) {
+    newTasks.insert(task.wId);
+  }
+
+  std::vector<WId> oldTasks;
+  for (const auto& taskItem : taskItems_) {
+    if (newTasks.count(taskItem.first) == 0) {
+      oldTasks.push_back(taskItem.first);
+    }
+  }
+
+  for (const auto wId : oldTasks) {
+    removeTask(wId);
+  }
+  for (const auto& task : tasks) {
+    addTask(task);
+  }
   resizeTaskManager();
 }
 
 void DockPanel::addTask(const TaskInfo& task) {
   // Checks is the task already exists.
-  for (auto& item : items_) {
-    if (item->hasTask(task.wId)) {
-      return;
-    }
+  if (taskItems_.count(task.wId) > 0) {
+    return;
   }
 
-  // Tries adding the task to existing programs.
-  for (auto& item : items_) {
-    if (item->addTask(task)) {
-      return;
-    }
+  // Tries adding the task to an existing program.
+  DockItem* program = taskCommandItems_.value(task.command);
+  if (program != nullptr && program->addTask(task)) {
+    taskItems_[task.wId] = program;
+    return;
   }
 
-  int i = 0;
-  for (; i < itemCount() && items_[i]->beforeTask(task.command); ++i);
+  const int i = findTaskCommandInsertionIndex(task.command);
   if (task.icon.isNull()) {
-      items_.insert(items_.begin() + i, std::make_unique<Program>(
+      insertItem(i, std::make_unique<Program>(
             this, model_, task.name, orientation_, "xapp", minSize_,
             maxSize_, task.command, task.command, /*pinned=*/false));
   }
   else {
-      items_.insert(items_.begin() + i, std::make_unique<Program>(
+      insertItem(i, std::make_unique<Program>(
             this, model_, task.name, orientation_, task.icon, minSize_,
             maxSize_, task.command, task.command, /*pinned=*/false));
   }
   items_[i]->addTask(task);
+  taskItems_[task.wId] = items_[i].get();
 }
 
-void DockPanel::removeTask(WId wId) {
-  for (int i = 0; i < itemCount(); ++i) {
-    if (items_[i]->removeTask(wId)) {
-      if (items_[i]->shouldBeRemoved()) {
-        items_.erase(items_.begin() + i);
-        resizeTaskManager();
-      }
-      return;
-    }
+bool DockPanel::removeTask(WId wId) {
+  const auto it = taskItems_.find(wId);
+  if (it == taskItems_.end()) {
+    return false;
   }
+
+  DockItem* item = it->second;
+  taskItems_.erase(it);
+  item->removeTask(wId);
+  if (item->shouldBeRemoved()) {
+    removeItem(item->slot_);
+    return true;
+  }
+  return false;
 }
 
-void DockPanel::updateTask(WId wId) {
-  const TaskInfo& task = taskHelper_.getTaskInfo(wId);
-  for (auto& item : items_) {
-    if (item->updateTask(task)) {
-      return;
-    }
+void DockPanel::updateTask(const TaskInfo& task) {
+  const auto it = taskItems_.find(task.wId);
+  if (it != taskItems_.end()) {
+    it->second->updateTask(task);
   }
 }
 
 void DockPanel::initClock() {
   if (showClock_) {
-    items_.push_back(std::make_unique<Clock>(
+    appendItem(std::make_unique<Clock>(
         this, model_, orientation_, minSize_, maxSize_));
   }
 }
 
+void DockPanel::insertItem(int i, std::unique_ptr<DockItem> item) {
+  isIconAtlasValid_ = false;
+  itemGeometry_.insert(i, item->minSize_);
+  items_.insert(items_.begin() + i, std::move(item));
+  updateItemSlots(i);
+  addTaskCommandItem(items_[i].get());
+}
+
+void DockPanel::removeItem(int i) {
+  removeTaskItems(i, i);
+  removeTaskCommandItems(i, i);
+  itemGeometry_.erase(i);
+  items_.erase(items_.begin() + i);
+  isIconAtlasValid_ = false;
+  updateItemSlots(i);
+}
+
+void DockPanel::truncateItems(int count) {
+  removeTaskItems(count, itemCount() - 1);
+  removeTaskCommandItems(count, itemCount() - 1);
+  itemGeometry_.truncate(count);
+  items_.resize(count);
+  isIconAtlasValid_ = false;
+}
+
+void DockPanel::updateItemSlots(int first) {
+  for (int i = first; i < itemCount(); ++i) {
+    items_[i]->geometry_ = &itemGeometry_;
+    items_[i]->slot_ = i;
+  }
+}
+
+void DockPanel::removeTaskItems(int first, int last) {
+  for (auto it = taskItems_.begin(); it != taskItems_.end();) {
+    const int slot = it->second->slot_;
+    if (slot >= first && slot <= last) {
+      it = taskItems_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+void DockPanel::addTaskCommandItem(DockItem* item) {
+  const QString taskCommand = item->getTaskCommand();
+  if (taskCommand.isEmpty()) {
+    return;
+  }
+
+  for (const auto& command : getTaskCommandAliases(taskCommand)) {
+    auto& existing = taskCommandItems_[command];
+    if (existing == nullptr || existing->slot_ > item->slot_) {
+      existing = item;
+    }
+  }
+}
+
+void DockPanel::removeTaskCommandItems(int first, int last) {
+  bool removed = false;
+  for (auto it = taskCommandItems_.begin(); it != taskCommandItems_.end();) {
+    const int slot = it.value()->slot_;
+    if (slot >= first && slot <= last) {
+      it = taskCommandItems_.erase(it);
+      removed = true;
+    } else {
+      ++it;
+    }
+  }
+
+  // Other items with the same task commands, if any, take their place.
+  if (removed) {
+    for (int i = 0; i < itemCount(); ++i) {
+      if (i < first || i > last) {
+        addTaskCommandItem(items_[i].get());
+      }
+    }
+  }
+}
+
+int DockPanel::findTaskCommandInsertionIndex(const QString& taskCommand) const {
+  // A linear scan, as this is only needed when the first task of a program is
+  // added, and the first section of programs is short.
+  int i = applicationMenuItemCount() + pagerItemCount();
+  for (; i < itemCount(); ++i) {
+    const QString itemTaskCommand = items_[i]->getTaskCommand();
+    if (itemTaskCommand.isEmpty() || !(itemTaskCommand < taskCommand)) {
+      break;
+    }
+  }
+  return i;
+}
+
 void DockPanel::initLayoutVars() {
   itemSpacing_ = static_cast<int>(minSize_ * spacingFactor_);
   parabolicMaxX_ = static_cast<int>(2.5 * (minSize_ + itemSpacing_));
-  numAnimationSteps_ = 20;
-  animationSpeed_ = 16;
+  initZoomSizes();
 
   QFont font;
   font.setFamily(font.defaultFamily());
@@ -795,17 +1184,17 @@ void DockPanel::initLayoutVars() {
   // maxHeight_ (vertical mode).
   int delta = 0;
   if (itemCount() >= 5) {
-    delta = parabolic(0) + 2 * parabolic(distance) +
-        2 * parabolic(2 * distance) - 5 * minSize_;
+    delta = zoomSize(0) + 2 * zoomSize(distance) +
+        2 * zoomSize(2 * distance) - 5 * minSize_;
   } else if (itemCount() == 4) {
-    delta = parabolic(0) + 2 * parabolic(distance) +
-        parabolic(2 * distance) - 4 * minSize_;
+    delta = zoomSize(0) + 2 * zoomSize(distance) +
+        zoomSize(2 * distance) - 4 * minSize_;
   } else if (itemCount() == 3) {
-    delta = parabolic(0) + 2 * parabolic(distance) - 3 * minSize_;
+    delta = zoomSize(0) + 2 * zoomSize(distance) - 3 * minSize_;
   } else if (itemCount() == 2) {
-    delta = parabolic(0) + parabolic(distance) - 2 * minSize_;
+    delta = zoomSize(0) + zoomSize(distance) - 2 * minSize_;
   } else if (itemCount() == 1) {
-    delta = parabolic(0) - minSize_;
+    delta = zoomSize(0) - minSize_;
   }
 
   if (orientation_ == Qt::Horizontal) {
@@ -825,81 +1214,95 @@ void DockPanel::initLayoutVars() {
     maxHeight_ = minHeight_ + delta;
     maxWidth_ = itemSpacing_ + maxSize_;
   }
+
+  updateMinPositions();
+  isZoomWindowValid_ = false;
+}
+
+void DockPanel::updateMinPositions() {
+  minPositions_.resize(itemCount());
+  int position = itemSpacing_ / 2;
+  for (int i = 0; i < itemCount(); ++i) {
+    const int length = isHorizontal() ? items_[i]->getMinWidth()
+                                      : items_[i]->getMinHeight();
+    minPositions_[i] = position;
+    itemGeometry_.minCenter(i) = position + length / 2;
+    position += length + itemSpacing_;
+  }
+  minEndPosition_ = position - itemSpacing_;
 }
 
 void DockPanel::updateLayout() {
   const int distance = minSize_ + itemSpacing_;
   if (isLeaving_) {
-    for (const auto& item : items_) {
-      item->setAnimationStartAsCurrent();
-      if (isHorizontal()) {
-        startBackgroundWidth_ = backgroundWidth_;
-        startBackgroundHeight_ = distance;
-      } else {  // Vertical
-        startBackgroundHeight_ = backgroundHeight_;
-        startBackgroundWidth_ = distance;
-      }
+    itemGeometry_.setAnimationStartAsCurrent();
+    if (isHorizontal()) {
+      itemGeometry_.startBackgroundWidth() = itemGeometry_.backgroundWidth();
+      itemGeometry_.startBackgroundHeight() = distance;
+    } else {  // Vertical
+      itemGeometry_.startBackgroundHeight() = itemGeometry_.backgroundHeight();
+      itemGeometry_.startBackgroundWidth() = distance;
     }
   }
 
   for (int i = 0; i < itemCount(); ++i) {
-    items_[i]->size_ = minSize_;
+    itemGeometry_.size(i) = minSize_;
     if (isHorizontal()) {
-      items_[i]->left_ = (i == 0) ? itemSpacing_ / 2
-          : items_[i - 1]->left_ + items_[i - 1]->getMinWidth() + itemSpacing_;
-      items_[i]->top_ = itemSpacing_ / 2;
-      items_[i]->minCenter_ = items_[i]->left_ + items_[i]->getMinWidth() / 2;
+      itemGeometry_.left(i) = minPositions_[i];
+      itemGeometry_.top(i) = itemSpacing_ / 2;
     } else {  // Vertical
-      items_[i]->left_ = itemSpacing_ / 2;
-      items_[i]->top_ = (i == 0) ? itemSpacing_ / 2
-          : items_[i - 1]->top_ + items_[i - 1]->getMinHeight() + itemSpacing_;
-      items_[i]->minCenter_ = items_[i]->top_ + items_[i]->getMinHeight() / 2;
+      itemGeometry_.left(i) = itemSpacing_ / 2;
+      itemGeometry_.top(i) = minPositions_[i];
     }
   }
+  isZoomWindowValid_ = false;
+  updateItemBoundaries(0, itemCount() - 1);
+
   if (isHorizontal()) {
-    backgroundWidth_ = minWidth_;
-    backgroundHeight_ = distance;
+    itemGeometry_.backgroundWidth() = minWidth_;
+    itemGeometry_.backgroundHeight() = distance;
   } else {  // Vertical
-    backgroundHeight_ = minHeight_;
-    backgroundWidth_ = distance;
+    itemGeometry_.backgroundHeight() = minHeight_;
+    itemGeometry_.backgroundWidth() = distance;
   }
 
   if (isLeaving_) {
-    for (const auto& item : items_) {
-      item->endSize_ = item->size_;
+    auto& g = itemGeometry_;
+    for (int i = 0; i < itemCount(); ++i) {
+      g.endSize(i) = g.size(i);
       if (isHorizontal()) {
-        item->endLeft_ = item->left_ + (screenGeometry_.width() - minWidth_) / 2
+        g.endLeft(i) = g.left(i) + (screenGeometry_.width() - minWidth_) / 2
             - x() + screenGeometry_.x();
         if (position_ == PanelPosition::Top) {
-          item->endTop_ = item->top_ + minHeight_ - distance;
+          g.endTop(i) = g.top(i) + minHeight_ - distance;
         } else {  // Bottom
-          item->endTop_ = item->top_ + (maxHeight_ - minHeight_);
+          g.endTop(i) = g.top(i) + (maxHeight_ - minHeight_);
         }
       } else {  // Vertical
-        item->endTop_ = item->top_ + (screenGeometry_.height() - minHeight_) / 2
+        g.endTop(i) = g.top(i) + (screenGeometry_.height() - minHeight_) / 2
             - y() + screenGeometry_.y();
         if (position_ == PanelPosition::Left) {
-          item->endLeft_ = item->left_ + minWidth_ - distance;
+          g.endLeft(i) = g.left(i) + minWidth_ - distance;
         } else {  // Right
-          item->endLeft_ = item->left_ + (maxWidth_ - minWidth_);
+          g.endLeft(i) = g.left(i) + (maxWidth_ - minWidth_);
         }
       }
-      item->startAnimation(numAnimationSteps_);
     }
+    g.startAnimation();
     if (isHorizontal()) {
-      endBackgroundWidth_ = minWidth_;
-      backgroundWidth_ = startBackgroundWidth_;
-      endBackgroundHeight_ = autoHide() ? kAutoHideSize : distance;
-      backgroundHeight_ = startBackgroundHeight_;
+      itemGeometry_.endBackgroundWidth() = minWidth_;
+      itemGeometry_.backgroundWidth() = itemGeometry_.startBackgroundWidth();
+      itemGeometry_.endBackgroundHeight() =
+          autoHide() ? kAutoHideSize : distance;
+      itemGeometry_.backgroundHeight() = itemGeometry_.startBackgroundHeight();
     } else {  // Vertical
-      endBackgroundHeight_ = minHeight_;
-      backgroundHeight_ = startBackgroundHeight_;
-      endBackgroundWidth_ = autoHide() ? kAutoHideSize : distance;
-      backgroundWidth_ = startBackgroundWidth_;
+      itemGeometry_.endBackgroundHeight() = minHeight_;
+      itemGeometry_.backgroundHeight() = itemGeometry_.startBackgroundHeight();
+      itemGeometry_.endBackgroundWidth() =
+          autoHide() ? kAutoHideSize : distance;
+      itemGeometry_.backgroundWidth() = itemGeometry_.startBackgroundWidth();
     }
-    currentAnimationStep_ = 0;
-    isAnimationActive_ = true;
-    animationTimer_->start(32 - animationSpeed_);
+    startAnimation();
   } else {
     isMinimized_ = true;
     resize(minWidth_, minHeight_);
@@ -908,121 +1311,102 @@ void DockPanel::updateLayout() {
 }
 
 void DockPanel::updateLayout(int x, int y) {
+  PaintTimer timer(paintProfiler_.get(), PaintProfiler::kLayout);
   const int distance = minSize_ + itemSpacing_;
   if (isEntering_) {
-    for (const auto& item : items_) {
-      item->startSize_ = item->size_;
+    auto& g = itemGeometry_;
+    for (int i = 0; i < itemCount(); ++i) {
+      g.startSize(i) = g.size(i);
       if (isHorizontal()) {
-        item->startLeft_ = item->left_ + (maxWidth_ - minWidth_) / 2;
+        g.startLeft(i) = g.left(i) + (maxWidth_ - minWidth_) / 2;
         if (position_ == PanelPosition::Top) {
-          item->startTop_ = item->top_ + minHeight_ - distance;
+          g.startTop(i) = g.top(i) + minHeight_ - distance;
         } else {  // Bottom
-          item->startTop_ = item->top_ + (maxHeight_ - minHeight_);
+          g.startTop(i) = g.top(i) + (maxHeight_ - minHeight_);
         }
       } else {  // Vertical
-        item->startTop_ = item->top_ + (maxHeight_ - minHeight_) / 2;
+        g.startTop(i) = g.top(i) + (maxHeight_ - minHeight_) / 2;
         if (position_ == PanelPosition::Left) {
-          item->startLeft_ = item->left_ + minWidth_ - distance;
+          g.startLeft(i) = g.left(i) + minWidth_ - distance;
         } else {  // Right
-          item->startLeft_ = item->left_ + (maxWidth_ - minWidth_);
+          g.startLeft(i) = g.left(i) + (maxWidth_ - minWidth_);
         }
       }
     }
     if (isHorizontal()) {
-      startBackgroundWidth_ = minWidth_;
-      startBackgroundHeight_ = autoHide() ? kAutoHideSize : distance;
+      itemGeometry_.startBackgroundWidth() = minWidth_;
+      itemGeometry_.startBackgroundHeight() =
+          autoHide() ? kAutoHideSize : distance;
     } else {  // Vertical
-      startBackgroundHeight_ = minHeight_;
-      startBackgroundWidth_ = autoHide() ? kAutoHideSize : distance;
+      itemGeometry_.startBackgroundHeight() = minHeight_;
+      itemGeometry_.startBackgroundWidth() =
+          autoHide() ? kAutoHideSize : distance;
     }
   }
 
-  int first_update_index = -1;
-  int last_update_index = 0;
-  if (isHorizontal()) {
-    items_[0]->left_ = itemSpacing_ / 2;
-  } else {  // Vertical
-    items_[0]->top_ = itemSpacing_ / 2;
-  }
-  for (int i = 0; i < itemCount(); ++i) {
-    int delta;
-    if (isHorizontal()) {
-      delta = std::abs(items_[i]->minCenter_ - x + (width() - minWidth_) / 2);
-    } else {  // Vertical
-      delta = std::abs(items_[i]->minCenter_ - y + (height() - minHeight_) / 2);
-    }
-    if (delta < parabolicMaxX_) {
-      if (first_update_index == -1) {
-        first_update_index = i;
-      }
-      last_update_index = i;
-    }
-    items_[i]->size_ = parabolic(delta);
-    if (position_ == PanelPosition::Top) {
-      items_[i]->top_ = itemSpacing_ / 2;
-    } else if (position_ == PanelPosition::Bottom) {
-      items_[i]->top_ = itemSpacing_ / 2 + maxSize_ - items_[i]->getHeight();
-    } else if (position_ == PanelPosition::Left) {
-      items_[i]->left_ = itemSpacing_ / 2;
-    } else {  // Right
-      items_[i]->left_ = itemSpacing_ / 2 + maxSize_ - items_[i]->getWidth();
-    }
-    if (i > 0) {
-      if (isHorizontal()) {
-        items_[i]->left_ = items_[i - 1]->left_ + items_[i - 1]->getWidth()
-            + itemSpacing_;
-      } else {  // Vertical
-        items_[i]->top_ = items_[i - 1]->top_ + items_[i - 1]->getHeight()
-            + itemSpacing_;
-      }
-    }
-  }
-  for (int i = itemCount() - 1; i >= last_update_index + 1; --i) {
-    if (isHorizontal()) {
-      items_[i]->left_ = (i == itemCount() - 1)
-          ? maxWidth_ - itemSpacing_ / 2 - items_[i]->getMinWidth()
-          : items_[i + 1]->left_ - items_[i]->getMinWidth() - itemSpacing_;
-    } else {  // Vertical
-      items_[i]->top_ = (i == itemCount() - 1)
-          ? maxHeight_ - itemSpacing_ / 2 - items_[i]->getMinHeight()
-          : items_[i + 1]->top_ - items_[i]->getMinHeight() - itemSpacing_;
-    }
-  }
-  if (first_update_index == 0 && last_update_index < itemCount() - 1) {
-    for (int i = last_update_index; i >= first_update_index; --i) {
+  // The mouse position relative to the minimized layout.
+  const int mousePosition = isHorizontal()
+      ? x - (panelWidth() - minWidth_) / 2
+      : y - (panelHeight() - minHeight_) / 2;
+  const auto [first, last] = findZoomWindow(mousePosition);
+
+  // Items outside both the previous and the current zoom windows keep their
+  // positions, so only the items in between need updating.
+  int updateFirst = 0;
+  int updateLast = itemCount() - 1;
+  if (isZoomWindowValid_) {
+    updateFirst = std::min(first, zoomFirst_);
+    updateLast = std::min(std::max(last, zoomLast_), itemCount() - 1);
+  }
+  const bool isReanchored = first == 0 && last < itemCount() - 1;
+  // If the dock is already zoomed, only the old and the new bounds of the
+  // updated items need repainting.
+  const bool canRepaintPartially =
+      !isMinimized_ && !isEntering_ && isZoomWindowValid_;
+  QRegion damage;
+  if (canRepaintPartially) {
+    damage += itemsDirtyRect(isReanchored ? 0 : updateFirst, updateLast);
+  }
+  for (int i = updateFirst; i <= updateLast; ++i) {
+    updateItemLayout(i, mousePosition, first, last);
+  }
+  zoomFirst_ = first;
+  zoomLast_ = last;
+  isZoomWindowValid_ = true;
+
+  if (isReanchored) {
+    for (int i = last; i >= first; --i) {
       if (isHorizontal()) {
-        items_[i]->left_ = items_[i + 1]->left_ - items_[i]->getWidth()
-            - itemSpacing_;
+        itemGeometry_.left(i) = itemGeometry_.left(i + 1)
+            - items_[i]->getWidth() - itemSpacing_;
       } else {  // Vertical
-        items_[i]->top_ = items_[i + 1]->top_ - items_[i]->getHeight()
-            - itemSpacing_;
+        itemGeometry_.top(i) = itemGeometry_.top(i + 1)
+            - items_[i]->getHeight() - itemSpacing_;
       }
     }
+    updateFirst = 0;
   }
+  updateItemBoundaries(updateFirst, updateLast);
 
   if (isEntering_) {
-    for (const auto& item : items_) {
-      item->setAnimationEndAsCurrent();
-      item->startAnimation(numAnimationSteps_);
-    }
+    itemGeometry_.setAnimationEndAsCurrent();
+    itemGeometry_.startAnimation();
     if (isHorizontal()) {
-      endBackgroundWidth_ = maxWidth_;
-      backgroundWidth_ = startBackgroundWidth_;
-      endBackgroundHeight_ = distance;
-      backgroundHeight_ = startBackgroundHeight_;
+      itemGeometry_.endBackgroundWidth() = maxWidth_;
+      itemGeometry_.backgroundWidth() = itemGeometry_.startBackgroundWidth();
+      itemGeometry_.endBackgroundHeight() = distance;
+      itemGeometry_.backgroundHeight() = itemGeometry_.startBackgroundHeight();
       mouseX_ = x + (maxWidth_ - minWidth_) / 2;
     } else {  // Vertical
-      endBackgroundHeight_ = maxHeight_;
-      backgroundHeight_ = startBackgroundHeight_;
-      endBackgroundWidth_ = distance;
-      backgroundWidth_ = startBackgroundWidth_;
+      itemGeometry_.endBackgroundHeight() = maxHeight_;
+      itemGeometry_.backgroundHeight() = itemGeometry_.startBackgroundHeight();
+      itemGeometry_.endBackgroundWidth() = distance;
+      itemGeometry_.backgroundWidth() = itemGeometry_.startBackgroundWidth();
       mouseY_ = y + (maxHeight_ - minHeight_) / 2;
     }
 
-    currentAnimationStep_ = 0;
-    isAnimationActive_ = true;
     isEntering_ = false;
-    animationTimer_->start(32 - animationSpeed_);
+    startAnimation();
   } else {
     mouseX_ = x;
     mouseY_ = y;
@@ -1030,7 +1414,67 @@ void DockPanel::updateLayout(int x, int y) {
 
   resize(maxWidth_, maxHeight_);
   isMinimized_ = false;
-  update();
+  if (canRepaintPartially) {
+    damage += itemsDirtyRect(updateFirst, updateLast);
+    update(damage);
+  } else {
+    update();
+  }
+}
+
+std::pair<int, int> DockPanel::findZoomWindow(int mousePosition) const {
+  // The minimized centers are increasing so the zoom window is contiguous.
+  const auto& minCenters = itemGeometry_.minCenters();
+  const auto first = std::partition_point(
+      minCenters.begin(), minCenters.end(), [&](int minCenter) {
+        return minCenter <= mousePosition - parabolicMaxX_;
+      });
+  const auto end = std::partition_point(
+      first, minCenters.end(), [&](int minCenter) {
+        return minCenter < mousePosition + parabolicMaxX_;
+      });
+  if (first == end) {
+    return {1, 0};
+  }
+  return {static_cast<int>(first - minCenters.begin()),
+          static_cast<int>(end - minCenters.begin()) - 1};
+}
+
+void DockPanel::updateItemLayout(int i, int mousePosition, int first,
+                                 int last) {
+  auto& item = items_[i];
+  itemGeometry_.size(i) = (i < first || i > last)
+      ? minSize_
+      : zoomSize(std::abs(itemGeometry_.minCenter(i) - mousePosition));
+  if (position_ == PanelPosition::Top) {
+    itemGeometry_.top(i) = itemSpacing_ / 2;
+  } else if (position_ == PanelPosition::Bottom) {
+    itemGeometry_.top(i) = itemSpacing_ / 2 + maxSize_ - item->getHeight();
+  } else if (position_ == PanelPosition::Left) {
+    itemGeometry_.left(i) = itemSpacing_ / 2;
+  } else {  // Right
+    itemGeometry_.left(i) = itemSpacing_ / 2 + maxSize_ - item->getWidth();
+  }
+
+  int position;
+  if (i < first) {
+    position = minPositions_[i];
+  } else if (i > last) {
+    // Anchored to the end of the zoomed dock.
+    position = (isHorizontal() ? maxWidth_ : maxHeight_) - itemSpacing_ / 2
+        - (minEndPosition_ - minPositions_[i]);
+  } else if (i == first) {
+    position = minPositions_[i];
+  } else {
+    position = isHorizontal()
+        ? itemGeometry_.left(i - 1) + items_[i - 1]->getWidth() + itemSpacing_
+        : itemGeometry_.top(i - 1) + items_[i - 1]->getHeight() + itemSpacing_;
+  }
+  if (isHorizontal()) {
+    itemGeometry_.left(i) = position;
+  } else {  // Vertical
+    itemGeometry_.top(i) = position;
+  }
 }
 
 void DockPanel::resizeTaskManager() {
@@ -1044,63 +1488,50 @@ void DockPanel::resizeTaskManager() {
     // Need to call QWidget::resize(), not DockPanel::resize(), in order not to
     // mess up the zooming.
     QWidget::resize(maxWidth_, maxHeight_);
+    if (fixedSizeWindow_) {
+      setMask(QRegion(rect()));
+    }
     if (isHorizontal()) {
-      backgroundWidth_ = maxWidth_;
+      itemGeometry_.backgroundWidth() = maxWidth_;
     } else {
-      backgroundHeight_ = maxHeight_;
+      itemGeometry_.backgroundHeight() = maxHeight_;
     }
   }
 
   const int itemsToKeep = (showApplicationMenu_ ? 1 : 0) +
       (showPager_ ? KWindowSystem::numberOfDesktops() : 0);
-  int left = 0;
-  int top = 0;
-  for (int i = 0; i < itemCount(); ++i) {
-    if (isHorizontal()) {
-      left = (i == 0) ? itemSpacing_ / 2
-                      : left + items_[i - 1]->getMinWidth() + itemSpacing_;
-      if (i >= itemsToKeep) {
-        items_[i]->minCenter_ = left + items_[i]->getMinWidth() / 2;
-      }
-    } else {  // Vertical
-      top = (i == 0) ? itemSpacing_ / 2
-                     : top + items_[i - 1]->getMinHeight() + itemSpacing_;
-      if (i >= itemsToKeep) {
-        items_[i]->minCenter_ = top + items_[i]->getMinHeight() / 2;
-      }
-    }
-  }
-
   int last_update_index = 0;
   for (int i = itemsToKeep; i < itemCount(); ++i) {
     int delta;
     if (isHorizontal()) {
-      delta = std::abs(items_[i]->minCenter_ - mouseX_ +
+      delta = std::abs(itemGeometry_.minCenter(i) - mouseX_ +
                        (width() - minWidth_) / 2);
     } else {  // Vertical
-      delta = std::abs(items_[i]->minCenter_ - mouseY_ +
+      delta = std::abs(itemGeometry_.minCenter(i) - mouseY_ +
                        (height() - minHeight_) / 2);
     }
     if (delta < parabolicMaxX_) {
       last_update_index = i;
     }
-    items_[i]->size_ = parabolic(delta);
+    itemGeometry_.size(i) = zoomSize(delta);
     if (position_ == PanelPosition::Top) {
-      items_[i]->top_ = itemSpacing_ / 2;
+      itemGeometry_.top(i) = itemSpacing_ / 2;
     } else if (position_ == PanelPosition::Bottom) {
-      items_[i]->top_ = itemSpacing_ / 2 + maxSize_ - items_[i]->getHeight();
+      itemGeometry_.top(i) =
+          itemSpacing_ / 2 + maxSize_ - items_[i]->getHeight();
     } else if (position_ == PanelPosition::Left) {
-      items_[i]->left_ = itemSpacing_ / 2;
+      itemGeometry_.left(i) = itemSpacing_ / 2;
     } else {  // Right
-      items_[i]->left_ = itemSpacing_ / 2 + maxSize_ - items_[i]->getWidth();
+      itemGeometry_.left(i) =
+          itemSpacing_ / 2 + maxSize_ - items_[i]->getWidth();
     }
     if (i > 0) {
       if (isHorizontal()) {
-        items_[i]->left_ = items_[i - 1]->left_ + items_[i - 1]->getWidth()
-            + itemSpacing_;
+        itemGeometry_.left(i) = itemGeometry_.left(i - 1)
+            + items_[i - 1]->getWidth() + itemSpacing_;
       } else {  // Vertical
-        items_[i]->top_ = items_[i - 1]->top_ + items_[i - 1]->getHeight()
-            + itemSpacing_;
+        itemGeometry_.top(i) = itemGeometry_.top(i - 1)
+            + items_[i - 1]->getHeight() + itemSpacing_;
       }
     }
   }
@@ -1108,15 +1539,18 @@ void DockPanel::resizeTaskManager() {
   for (int i = itemCount() - 1;
        i >= std::max(itemsToKeep, last_update_index + 1); --i) {
     if (isHorizontal()) {
-      items_[i]->left_ = (i == itemCount() - 1)
+      itemGeometry_.left(i) = (i == itemCount() - 1)
           ? maxWidth_ - itemSpacing_ / 2 - items_[i]->getMinWidth()
-          : items_[i + 1]->left_ - items_[i]->getMinWidth() - itemSpacing_;
+          : itemGeometry_.left(i + 1) - items_[i]->getMinWidth()
+              - itemSpacing_;
     } else {  // Vertical
-      items_[i]->top_ = (i == itemCount() - 1)
+      itemGeometry_.top(i) = (i == itemCount() - 1)
           ? maxHeight_ - itemSpacing_ / 2 - items_[i]->getMinHeight()
-          : items_[i + 1]->top_ - items_[i]->getMinHeight() - itemSpacing_;
+          : itemGeometry_.top(i + 1) - items_[i]->getMinHeight()
+              - itemSpacing_;
     }
   }
+  updateItemBoundaries(0, itemCount() - 1);
 
   update();
 }
@@ -1177,14 +1611,91 @@ void DockPanel::setStrut(int width) {
   }
 }
 
-int DockPanel::findActiveItem(int x, int y) {
-  int i = 0;
-  while (i < itemCount() &&
-      ((orientation_ == Qt::Horizontal && items_[i]->left_ < x) ||
-      (orientation_ == Qt::Vertical && items_[i]->top_ < y))) {
-    ++i;
+QRect DockPanel::backgroundRect() {
+  const int backgroundWidth = itemGeometry_.backgroundWidth();
+  const int backgroundHeight = itemGeometry_.backgroundHeight();
+  if (isHorizontal()) {
+    const int y = (position_ == PanelPosition::Top)
+                  ? 0 : panelHeight() - backgroundHeight;
+    return QRect((panelWidth() - backgroundWidth) / 2, y, backgroundWidth,
+                 backgroundHeight);
+  } else {  // Vertical
+    const int x =  (position_ == PanelPosition::Left)
+                   ? 0 : panelWidth() - backgroundWidth;
+    return QRect(x, (panelHeight() - backgroundHeight) / 2, backgroundWidth,
+                 backgroundHeight);
   }
-  return i - 1;
+}
+
+QRect DockPanel::itemsDirtyRect(int first, int last) {
+  if (first > last) {
+    return QRect();
+  }
+
+  // Items may paint a bit outside their bounds, e.g. the highlight.
+  const int margin = std::max(itemSpacing_ / 2, minSize_ / 4);
+  if (isHorizontal()) {
+    const int start = itemGeometry_.left(first) - margin;
+    const int end = itemGeometry_.left(last) + items_[last]->getWidth()
+        + margin;
+    return QRect(start, 0, end - start, panelHeight());
+  } else {  // Vertical
+    const int start = itemGeometry_.top(first) - margin;
+    const int end = itemGeometry_.top(last) + items_[last]->getHeight()
+        + margin;
+    return QRect(0, start, panelWidth(), end - start);
+  }
+}
+
+void DockPanel::startAnimation() {
+  animationClock_.start();
+  isAnimationActive_ = true;
+  animationTimer_->start(animationFrameInterval());
+}
+
+int DockPanel::animationFrameInterval() const {
+  const QScreen* screen = (windowHandle() != nullptr)
+      ? windowHandle()->screen() : QGuiApplication::primaryScreen();
+  const qreal refreshRate = (screen != nullptr) ? screen->refreshRate() : 0;
+  return (refreshRate > 0)
+      ? std::max(static_cast<int>(1000 / refreshRate), 1)
+      : kDefaultAnimationFrameIntervalMs;
+}
+
+void DockPanel::updateItemBoundaries(int first, int last) {
+  itemBoundaries_.resize(itemCount() + 1);
+  if (itemCount() == 0) {
+    return;
+  }
+
+  auto start = [this](int i) {
+    return isHorizontal() ? itemGeometry_.left(i) : itemGeometry_.top(i);
+  };
+  auto end = [this](int i) {
+    return isHorizontal() ? itemGeometry_.left(i) + items_[i]->getWidth()
+                          : itemGeometry_.top(i) + items_[i]->getHeight();
+  };
+
+  // Boundary i only depends on items i - 1 and i. It is kept between their
+  // starts so that the boundaries stay sorted even if the items overlap.
+  for (int i = std::max(first, 0); i <= std::min(last + 1, itemCount()); ++i) {
+    if (i == 0) {
+      itemBoundaries_[i] = start(0) - itemSpacing_ / 2;
+    } else if (i == itemCount()) {
+      itemBoundaries_[i] = end(i - 1) + itemSpacing_ / 2;
+    } else {
+      itemBoundaries_[i] = std::max(
+          start(i - 1), std::min((end(i - 1) + start(i)) / 2, start(i)));
+    }
+  }
+}
+
+int DockPanel::findActiveItem(int x, int y) {
+  const int position = isHorizontal() ? x : y;
+  const int i = static_cast<int>(
+      std::upper_bound(itemBoundaries_.begin(), itemBoundaries_.end(),
+                       position) - itemBoundaries_.begin()) - 1;
+  return (i >= 0 && i < itemCount()) ? i : -1;
 }
 
 void DockPanel::showTooltip(int x, int y) {
@@ -1202,21 +1713,21 @@ void DockPanel::showTooltip(int i) {
   tooltip_.setText(items_[i]->getLabel());
   int x, y;
   if (position_ == PanelPosition::Top) {
-    x = geometry().x() + items_[i]->left_
+    x = geometry().x() + itemGeometry_.left(i)
         - tooltip_.width() / 2 + items_[i]->getWidth() / 2;
     y = geometry().y() + maxHeight_ + kTooltipSpacing;
   } else if (position_ == PanelPosition::Bottom) {
-    x = geometry().x() + items_[i]->left_
+    x = geometry().x() + itemGeometry_.left(i)
         - tooltip_.width() / 2 + items_[i]->getWidth() / 2;
     // No need for additional tooltip spacing in this position.
     y = geometry().y() - tooltip_.height() + 12;
   } else if (position_ == PanelPosition::Left) {
     x = geometry().x() + maxWidth_ + kTooltipSpacing;
-    y = geometry().y() + items_[i]->top_
+    y = geometry().y() + itemGeometry_.top(i)
         - tooltip_.height() / 2 + items_[i]->getHeight() / 2;
   } else {  // Right
     x = geometry().x() - tooltip_.width() - kTooltipSpacing;
-    y = geometry().y() + items_[i]->top_
+    y = geometry().y() + itemGeometry_.top(i)
         - tooltip_.height() / 2 + items_[i]->getHeight() / 2;
   }
   tooltip_.move(x, y);
@@ -1228,16 +1739,36 @@ void DockPanel::showWaitCursor() {
   QTimer::singleShot(1000 /* msecs */, this, SLOT(resetCursor()));
 }
 
-int DockPanel::parabolic(int x) const {
-  // Assume x >= 0.
-  if (x > 30) {
-      x *= 2.2;
-  }
-  if (x >= parabolicMaxX_) {
-    return minSize_;
-  } else {
-    return maxSize_ -
-        (x * x * (maxSize_ - minSize_)) / (parabolicMaxX_ * parabolicMaxX_);
+void DockPanel::initZoomSizes() {
+  zoomSizes_.resize(parabolicMaxX_ + 1);
+  const int delta = maxSize_ - minSize_;
+  for (int x = 0; x <= parabolicMaxX_; ++x) {
+    int size = minSize_;
+    switch (zoomCurve_) {
+      case ZoomCurve::Cosine:
+        size = minSize_ + static_cast<int>(std::lround(
+            delta * (1 + std::cos(M_PI * x / parabolicMaxX_)) / 2));
+        break;
+      case ZoomCurve::Gaussian: {
+        // Standard deviation so that the curve is almost flat at
+        // parabolicMaxX_.
+        const double sigma = parabolicMaxX_ / 3.0;
+        size = minSize_ + static_cast<int>(std::lround(
+            delta * std::exp(-x * x / (2 * sigma * sigma))));
+        break;
+      }
+      case ZoomCurve::Parabolic:  // fall through
+      default: {
+        // Narrower than the other curves.
+        const int distance = (x > 30) ? static_cast<int>(x * 2.2) : x;
+        if (distance < parabolicMaxX_) {
+          size = maxSize_ -
+              (distance * distance * delta) / (parabolicMaxX_ * parabolicMaxX_);
+        }
+        break;
+      }
+    }
+    zoomSizes_[x] = size;
   }
 }
 
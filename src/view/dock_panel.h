@@ -20,14 +20,22 @@
 #define KSMOOTHDOCK_DOCK_PANEL_H_
 
 #include <memory>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include <QAction>
+#include <QEasingCurve>
+#include <QElapsedTimer>
+#include <QHash>
 #include <QMenu>
 #include <QMouseEvent>
 #include <QPaintEvent>
+#include <QPainter>
+#include <QPixmap>
 #include <QPoint>
 #include <QRect>
+#include <QRegion>
 #include <QSize>
 #include <QString>
 #include <QTimer>
@@ -35,13 +43,14 @@
 
 #include <KAboutApplicationDialog>
 #include <KWindowSystem>
-#include <kactivities/consumer.h>
 
 #include "add_panel_dialog.h"
 #include "application_menu_settings_dialog.h"
 #include "appearance_settings_dialog.h"
 #include "dock_item.h"
+#include "dock_item_geometry.h"
 #include "edit_launchers_dialog.h"
+#include "paint_profiler.h"
 #include "task_manager_settings_dialog.h"
 #include "tooltip.h"
 #include "wallpaper_settings_dialog.h"
@@ -74,6 +83,9 @@ class DockPanel : public QWidget {
                                        const QRect& subMenuGeometry);
   void addPanelSettings(QMenu* menu);
 
+  // Repaints only the part of the dock that the item paints in.
+  void updateItem(const DockItem* item);
+
  public slots:
   // Reloads the items and updates the dock.
   void reload();
@@ -142,6 +154,12 @@ class DockPanel : public QWidget {
   // Slot to update zoom animation.
   void updateAnimation();
 
+  // Slot to lay out the dock at the latest coalesced mouse position.
+  void updateLayoutForMouseMove();
+
+  // Writes the paint profile to the log and to a file in the temp dir.
+  void dumpPaintProfile();
+
   void showWaitCursor();
   void resetCursor();
 
@@ -162,12 +180,14 @@ class DockPanel : public QWidget {
   void cloneDock();
   void removeDock();
 
-  void onWindowAdded(WId wId);
-  void onWindowRemoved(WId wId);
-  void onWindowChanged(WId wId, NET::Properties properties,
-                       NET::Properties2 properties2);
+  // The task changes, as signalled by TaskHelper.
+  void onTaskAdded(const TaskInfo& task, int screen, bool onCurrentDesktop);
+  void onTaskMoved(const TaskInfo& task, int screen, bool onCurrentDesktop);
+  void onTaskRemoved(WId wId);
+  void onTaskChanged(const TaskInfo& task);
 
  protected:
+  virtual bool event(QEvent* e) override;
   virtual void paintEvent(QPaintEvent* e) override;
   virtual void mouseMoveEvent(QMouseEvent* e) override;
   virtual void mousePressEvent(QMouseEvent* e) override;
@@ -181,9 +201,40 @@ class DockPanel : public QWidget {
   // Width/height of the panel in Auto Hide mode.
   static constexpr int kAutoHideSize = 1;
 
+  // The max area of the icon atlas, in pixels. If the slots of all the items
+  // don't fit, the icons are drawn one by one.
+  static constexpr int kMaxIconAtlasArea = 2048 * 2048;
+  // The transparent gutter around each slot of the icon atlas, in device
+  // pixels, so that smooth scaling doesn't blend in the neighbouring icons.
+  static constexpr int kIconAtlasPadding = 1;
+
+  // The interval between two animation frames, in milliseconds, if the
+  // refresh rate of the screen is unknown.
+  static constexpr int kDefaultAnimationFrameIntervalMs = 16;
+
   bool isHorizontal() { return orientation_ == Qt::Horizontal; }
 
+  // Gets the interval between two animation frames, in milliseconds, which
+  // is one refresh of the dock's screen.
+  int animationFrameInterval() const;
+
   bool autoHide() { return visibility_ == PanelVisibility::AutoHide; }
+
+  // Whether the window is at its zoomed size while the panel is minimized,
+  // in which case the panel is only the masked part of the window.
+  bool hasMinimizedMask() { return fixedSizeWindow_ && isMinimized_; }
+
+  // The panel's size, which is the window's size unless hasMinimizedMask().
+  int panelWidth() { return hasMinimizedMask() ? minWidth_ : width(); }
+  int panelHeight() { return hasMinimizedMask() ? minHeight_ : height(); }
+
+  // The position of the minimized panel in the window, see
+  // hasMinimizedMask(). Mouse and paint coordinates are translated by it so
+  // that the layout doesn't depend on the window mode.
+  QPoint minimizedOffset();
+
+  // Gets the window's position on the screen given its size.
+  QPoint windowPosition(int w, int h);
   bool windowsCanCover() {
     return visibility_ == PanelVisibility::WindowsCanCover;
   }
@@ -194,6 +245,29 @@ class DockPanel : public QWidget {
 
   int itemCount() const { return static_cast<int>(items_.size()); }
 
+  // These keep items_ and itemGeometry_ in sync. Always use them instead of
+  // modifying items_ directly.
+  void insertItem(int i, std::unique_ptr<DockItem> item);
+  void appendItem(std::unique_ptr<DockItem> item) {
+    insertItem(itemCount(), std::move(item));
+  }
+  void removeItem(int i);
+  // Keeps only the first count items.
+  void truncateItems(int count);
+  // Points the items from index first onward to their slots in itemGeometry_.
+  void updateItemSlots(int first);
+  // Removes the tasks of the items from first to last from taskItems_.
+  void removeTaskItems(int first, int last);
+  // Adds the item's task command and its aliases to taskCommandItems_.
+  void addTaskCommandItem(DockItem* item);
+  // Removes the items from first to last from taskCommandItems_.
+  void removeTaskCommandItems(int first, int last);
+  // Gets the index to insert a new unpinned Program item for the task command
+  // at: before the first program in the first section of programs, i.e.
+  // before the first separator or the clock, whose task command doesn't sort
+  // before it.
+  int findTaskCommandInsertionIndex(const QString& taskCommand) const;
+
   int applicationMenuItemCount() const { return showApplicationMenu_ ? 1 : 0; }
 
   int launcherItemCount() const {
@@ -223,10 +297,19 @@ class DockPanel : public QWidget {
   void initPager();
   void initTasks();
   void reloadTasks();
+  // Shows the given tasks instead of the current ones. Only applies the
+  // difference, so that the launchers, the clock and the programs that keep
+  // their tasks are not recreated.
+  void updateTasks(const std::vector<TaskInfo>& tasks);
+  // Whether a task on this screen/desktop should be shown on this dock.
+  bool isTaskShown(int screen, bool onCurrentDesktop) const {
+    return (!model_->currentScreenTasksOnly() || screen == screen_) &&
+        (!model_->currentDesktopTasksOnly() || onCurrentDesktop);
+  }
   void addTask(const TaskInfo& task);
-  void addTask(WId wId) { addTask(taskHelper_.getTaskInfo(wId)); }
-  void removeTask(WId wId);
-  void updateTask(WId wId);
+  // Returns whether the task's item has been removed too.
+  bool removeTask(WId wId);
+  void updateTask(const TaskInfo& task);
   void initClock();
 
   void initLayoutVars();
@@ -236,15 +319,73 @@ class DockPanel : public QWidget {
   void updateLayout();
 
   // Updates width, height, items's size and position given the mouse position.
+  //
+  // This is incremental: only the items in the zoom window (i.e. within
+  // parabolicMaxX_ of the mouse) change size. Items before the zoom window stay
+  // at their minimized positions and items after it are shifted by a constant,
+  // so only the items in the previous and the current zoom windows need to be
+  // updated.
   void updateLayout(int x, int y);
 
+  // Computes the minimized positions and centers of the items.
+  void updateMinPositions();
+
+  // Finds the zoom window [first, last] given the mouse position relative to
+  // the minimized layout. An empty zoom window is returned as [1, 0] so that
+  // the first item stays and the others are shifted, as in the full layout.
+  std::pair<int, int> findZoomWindow(int mousePosition) const;
+
+  // Updates the size and position of the item at the specified index given
+  // the mouse position and the zoom window.
+  void updateItemLayout(int i, int mousePosition, int first, int last);
+
   // Resizes the task manager part of the panel. This needs to not interfere
   // with the zooming.
   void resizeTaskManager();
 
   void setStrut(int width);
 
-  // Finds the active item given the mouse position.
+  // Starts the zoom animation from the start to the end values in
+  // itemGeometry_.
+  void startAnimation();
+
+  // Returns the background's rect in the current layout.
+  QRect backgroundRect();
+
+  // Returns the strip of the dock, across its whole width or height, that the
+  // items from first to last may paint in the current layout. Used to only
+  // repaint the parts of the dock that have changed.
+  QRect itemsDirtyRect(int first, int last);
+
+  // Draws the current icons of the items in paintedItems_. The icons that are
+  // in the icon atlas are drawn in a single drawPixmapFragments() call, the
+  // others directly. Then copies the icons that are drawn directly but were
+  // also the icons of their items the last time into the atlas.
+  void drawIcons(QPainter* painter);
+
+  // Re-creates the icon atlas if the items or the device pixel ratio have
+  // changed. Returns false if the atlas would be too large.
+  bool updateIconAtlas();
+
+  // Copies the icons of the items in iconAtlasUpdates_ into their slots of the
+  // icon atlas.
+  void copyIconsToAtlas();
+
+  // Returns the slot of the item at the specified index in the icon atlas,
+  // excluding its gutter.
+  QRect iconAtlasSlot(int i) const {
+    const QSize pitch = iconAtlasSlotSize_
+        + QSize(2 * kIconAtlasPadding, 2 * kIconAtlasPadding);
+    return QRect(QPoint((i % iconAtlasColumns_) * pitch.width(),
+                        (i / iconAtlasColumns_) * pitch.height())
+                     + QPoint(kIconAtlasPadding, kIconAtlasPadding),
+                 iconAtlasSlotSize_);
+  }
+
+  // Updates the hit-test boundaries affected by the items from first to last.
+  void updateItemBoundaries(int first, int last);
+
+  // Finds the active item given the mouse position, or -1 if there is none.
   int findActiveItem(int x, int y);
 
   // Shows the appropriate tooltip given the mouse position.
@@ -252,8 +393,16 @@ class DockPanel : public QWidget {
   // Shows tool tip for the item at the specified index.
   void showTooltip(int i);
 
+  // Builds the zoom table, i.e. the item size for every distance to the mouse
+  // from 0 to parabolicMaxX_, according to the zoom curve.
+  void initZoomSizes();
+
   // Returns the size given the distance to the mouse.
-  int parabolic(int x) const;
+  int zoomSize(int distance) const {
+    // Assume distance >= 0.
+    return (distance < static_cast<int>(zoomSizes_.size()))
+        ? zoomSizes_[distance] : minSize_;
+  }
 
   MultiDockView* parent_;
 
@@ -272,6 +421,13 @@ class DockPanel : public QWidget {
   int minSize_;
   int maxSize_;
   float spacingFactor_;  // item spacing as ratio of minSize, in (0, 1) range.
+  // Whether the window always has the zoomed size, with the minimized panel
+  // shown and clickable through the window's mask.
+  bool fixedSizeWindow_;
+  ZoomCurve zoomCurve_;
+  int zoomUpdateRate_;  // max number of layouts per second on mouse moves.
+  int animationDuration_;  // of zooming in and out, in milliseconds.
+  QEasingCurve animationEasingCurve_;
   QColor backgroundColor_;  // including alpha.
   bool showBorder_;
   QColor borderColor_;  // no alpha.
@@ -287,17 +443,65 @@ class DockPanel : public QWidget {
   int minHeight_;
   int maxHeight_;
   int parabolicMaxX_;
+  // Item sizes indexed by the distance to the mouse, see initZoomSizes().
+  std::vector<int> zoomSizes_;
+  // Positions (x or y, depending on the orientation) of the items when
+  // minimized, i.e. the prefix offsets of the minimized layout.
+  std::vector<int> minPositions_;
+  // The end position of the last item when minimized.
+  int minEndPosition_;
+  // The zoom window from the last call of updateLayout(x, y).
+  int zoomFirst_;
+  int zoomLast_;
+  // Whether the items are laid out according to the zoom window above.
+  bool isZoomWindowValid_;
+  // Sorted hit-test boundaries (x or y, depending on the orientation) of the
+  // items in the current layout: item i owns [itemBoundaries_[i],
+  // itemBoundaries_[i + 1]). The spacing between two items is split in half
+  // between them.
+  std::vector<int> itemBoundaries_;
   QRect screenGeometry_;  // the geometry of the screen that the dock is on.
 
-  // Number of animation steps when zooming in and out.
-  int numAnimationSteps_;
-  // Animation speed, between 0 and 31. The higher the faster.
-  int animationSpeed_;
-
   Qt::Orientation orientation_;
 
   // The list of all dock items.
   std::vector<std::unique_ptr<DockItem>> items_;
+  // The geometry and animation state of the items, in the same order, and of
+  // the background.
+  DockItemGeometry itemGeometry_;
+  // The items that the tasks belong to, by window ID.
+  std::unordered_map<WId, DockItem*> taskItems_;
+  // The Program items by the task commands that they group, including the
+  // aliases (see kTaskCommandAliases). If several items have the same task
+  // command, this is the first one.
+  QHash<QString, DockItem*> taskCommandItems_;
+
+  // The indices of the items to draw in the current paint event, from the last
+  // to the first so that zoomed items don't get clipped by non-zoomed items.
+  std::vector<int> paintedItems_;
+  // The current icons of the items, each in a fixed-size slot in device
+  // pixels, so that they are all drawn from a single pixmap. An icon is only
+  // copied into its slot once it has been drawn twice in a row, so that the
+  // icons that change every frame while zooming are drawn directly instead of
+  // being copied then drawn again.
+  QPixmap iconAtlas_;
+  QSize iconAtlasSlotSize_;
+  int iconAtlasColumns_;
+  // Whether the atlas' slots fit the current items. The max sizes of the
+  // items don't change once they have been added, so the atlas only needs
+  // re-creating when the items are added or removed.
+  bool isIconAtlasValid_;
+  qreal iconAtlasDevicePixelRatio_;
+  // The cache keys of the icons in the slots, 0 if a slot is empty.
+  std::vector<qint64> iconAtlasKeys_;
+  // The cache keys of the icons that the items were last drawn with.
+  std::vector<qint64> lastIconKeys_;
+  // The items whose icons are to be copied into the atlas.
+  std::vector<int> iconAtlasUpdates_;
+  std::vector<QPainter::PixmapFragment> iconFragments_;
+
+  // Null unless paint profiling is enabled.
+  std::unique_ptr<PaintProfiler> paintProfiler_;
 
   // Context (right-click) menu.
   QMenu menu_;
@@ -325,8 +529,7 @@ class DockPanel : public QWidget {
   WallpaperSettingsDialog wallpaperSettingsDialog_;
   TaskManagerSettingsDialog taskManagerSettingsDialog_;
 
-  TaskHelper taskHelper_;
-  KActivities::Consumer activityManager_;
+  TaskHelper* taskHelper_;  // No ownership, shared by all the docks.
 
   // The tooltip object to show tooltip for the active item.
   Tooltip tooltip_;
@@ -337,21 +540,26 @@ class DockPanel : public QWidget {
   bool isLeaving_;
   bool isAnimationActive_;
   std::unique_ptr<QTimer> animationTimer_;
-  int currentAnimationStep_;
-  int backgroundWidth_;
-  int startBackgroundWidth_;
-  int endBackgroundWidth_;
-  int backgroundHeight_;
-  int startBackgroundHeight_;
-  int endBackgroundHeight_;
+  // Measures the time since the start of the zoom animation. Each frame
+  // samples it so the animation takes animationDuration_ regardless of how
+  // many frames are actually shown.
+  QElapsedTimer animationClock_;
 
   // For recording the mouse position before doing entering animation
   // so that we can show the correct tooltip at the end of it.
   int mouseX_;
   int mouseY_;
 
+  // Mouse moves are coalesced: the dock is laid out at most once per frame of
+  // the zoom update rate, at the latest mouse position.
+  std::unique_ptr<QTimer> mouseMoveTimer_;
+  bool hasPendingMouseMove_;
+  int pendingMouseX_;
+  int pendingMouseY_;
+
   friend class Program;  // for leaveEvent.
   friend class DockPanelTest;
+  friend class DockLayoutBench;
   friend class ConfigDialogTest;
   friend class EditLaunchersDialogTest;
 };
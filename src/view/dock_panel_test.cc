@@ -18,7 +18,10 @@
 
 #include "dock_panel.h"
 
+#include <algorithm>
+#include <cstdlib>
 #include <memory>
+#include <vector>
 
 #include <QTemporaryDir>
 #include <QtTest>
@@ -26,6 +29,7 @@
 #include <KWindowSystem>
 
 #include "multi_dock_view.h"
+#include "program.h"
 
 namespace ksmoothdock {
 
@@ -58,7 +62,50 @@ class DockPanelTest: public QObject {
   // Tests toggling the clock.
   void toggleClock();
 
+  // Tests that the incremental zoom layout matches the full layout, and that
+  // both place the items where the original full layout placed them.
+  void incrementalLayout();
+
+  // Tests hit testing of the items.
+  void findActiveItem();
+
+  // Tests that mouse moves within a frame are laid out once, at the latest
+  // position.
+  void coalesceMouseMoves();
+
+  // Tests that in fixed-size window mode the window keeps its zoomed size and
+  // the minimized panel is its mask.
+  void fixedSizeWindow();
+
+  // Tests that the icons are copied into the icon atlas once they have been
+  // drawn twice in a row.
+  void iconAtlas();
+
+  // Tests that reloading the tasks keeps the launchers and the clock.
+  void reloadTasks();
+
+  // Tests that updating the tasks only adds and removes the changed ones.
+  void updateTasks();
+
+  // Tests that a task whose command is an alias of a launcher's task command
+  // is added to the launcher.
+  void taskCommandAlias();
+
+  // Tests where the program of the first task of an unknown command is
+  // inserted among the launchers.
+  void newProgramPosition();
+
+  // Tests that removing the last task of a program removes its task command
+  // and its aliases from the index.
+  void removeProgramTaskCommands();
+
  private:
+  void setLaunchers(const std::vector<LauncherConfig>& launchers) {
+    model_->setDockLauncherConfigs(kDockId, launchers);
+    dock_->reload();
+    dock_->updateTasks({});
+  }
+
   void verifyPosition(PanelPosition position) {
     QCOMPARE(dock_->position_, position);
     QCOMPARE(dock_->orientation_,
@@ -105,6 +152,98 @@ class DockPanelTest: public QObject {
     QCOMPARE(dock_->itemCount(), itemCount);
   }
 
+  QVector<QRect> itemGeometries() {
+    QVector<QRect> geometries;
+    for (const auto& item : dock_->items_) {
+      geometries.append(QRect(item->left(), item->top(), item->getWidth(),
+                              item->getHeight()));
+    }
+    return geometries;
+  }
+
+  // Gets the positions of the items along the dock for the mouse at (x, y),
+  // computed the way the original full layout did: the items up to the end of
+  // the zoom window from the start of the dock, the items after it from the
+  // end of the dock. Uses the current item sizes.
+  QVector<int> referencePositions(int x, int y) {
+    const bool horizontal = dock_->isHorizontal();
+    const int count = dock_->itemCount();
+    const int mousePosition = horizontal
+        ? x - (dock_->panelWidth() - dock_->minWidth_) / 2
+        : y - (dock_->panelHeight() - dock_->minHeight_) / 2;
+    const auto length = [&](int i) {
+      return horizontal ? dock_->items_[i]->getWidth()
+                        : dock_->items_[i]->getHeight();
+    };
+    const auto minLength = [&](int i) {
+      return horizontal ? dock_->items_[i]->getMinWidth()
+                        : dock_->items_[i]->getMinHeight();
+    };
+
+    int first = -1;
+    int last = 0;
+    for (int i = 0; i < count; ++i) {
+      const int delta =
+          std::abs(dock_->itemGeometry_.minCenter(i) - mousePosition);
+      if (delta < dock_->parabolicMaxX_) {
+        if (first == -1) {
+          first = i;
+        }
+        last = i;
+      }
+    }
+
+    const int spacing = dock_->itemSpacing_;
+    QVector<int> positions(count);
+    for (int i = 0; i < count; ++i) {
+      positions[i] = (i == 0) ? spacing / 2
+                              : positions[i - 1] + length(i - 1) + spacing;
+    }
+    const int maxLength = horizontal ? dock_->maxWidth_ : dock_->maxHeight_;
+    for (int i = count - 1; i > last; --i) {
+      positions[i] = (i == count - 1)
+          ? maxLength - spacing / 2 - minLength(i)
+          : positions[i + 1] - minLength(i) - spacing;
+    }
+    if (first == 0 && last < count - 1) {
+      for (int i = last; i >= first; --i) {
+        positions[i] = positions[i + 1] - length(i) - spacing;
+      }
+    }
+    return positions;
+  }
+
+  QVector<int> itemPositions() {
+    QVector<int> positions;
+    for (const auto& item : dock_->items_) {
+      positions.append(dock_->isHorizontal() ? item->left() : item->top());
+    }
+    return positions;
+  }
+
+  // Draws the icons of all the items, as a paint event would.
+  void drawIcons() {
+    dock_->paintedItems_.clear();
+    for (int i = dock_->itemCount() - 1; i >= 0; --i) {
+      dock_->paintedItems_.push_back(i);
+    }
+    QImage image(dock_->maxWidth_, dock_->maxHeight_,
+                 QImage::Format_ARGB32_Premultiplied);
+    QPainter painter(&image);
+    dock_->drawIcons(&painter);
+  }
+
+  // Returns whether the atlas has the current icons of all the items.
+  bool isIconAtlasCurrent() {
+    for (int i = 0; i < dock_->itemCount(); ++i) {
+      const QPixmap* icon = dock_->items_[i]->getCurrentIcon();
+      if (icon != nullptr && dock_->iconAtlasKeys_[i] != icon->cacheKey()) {
+        return false;
+      }
+    }
+    return true;
+  }
+
   std::unique_ptr<MultiDockModel> model_;
   std::unique_ptr<MultiDockView> view_;
   std::unique_ptr<DockPanel> dock_;
@@ -150,6 +289,217 @@ void DockPanelTest::toggleClock() {
   verifyClock(true, itemCount);
 }
 
+void DockPanelTest::incrementalLayout() {
+  for (const auto position : {PanelPosition::Bottom, PanelPosition::Right}) {
+    dock_->updatePosition(position);
+    const bool horizontal = dock_->isHorizontal();
+    // Zooms in first so that the dock has its zoomed size.
+    dock_->updateLayout(0, 0);
+    const int length = horizontal ? dock_->maxWidth_ : dock_->maxHeight_;
+    for (int i = 0; i < length; i += 5) {
+      const int x = horizontal ? i : dock_->maxWidth_ / 2;
+      const int y = horizontal ? dock_->maxHeight_ / 2 : i;
+      dock_->updateLayout(x, y);
+      const auto incremental = itemGeometries();
+      QCOMPARE(itemPositions(), referencePositions(x, y));
+      dock_->isZoomWindowValid_ = false;
+      dock_->updateLayout(x, y);
+      QCOMPARE(incremental, itemGeometries());
+    }
+  }
+}
+
+void DockPanelTest::findActiveItem() {
+  dock_->updateLayout();
+  const int y = dock_->height() / 2;
+  QCOMPARE(dock_->findActiveItem(-1, y), -1);
+  for (int i = 0; i < dock_->itemCount(); ++i) {
+    const auto& item = dock_->items_[i];
+    QCOMPARE(dock_->findActiveItem(item->left() + item->getWidth() / 2, y), i);
+    // The spacing between two items is split between them.
+    QCOMPARE(dock_->findActiveItem(item->left() - 1, y), i);
+    QCOMPARE(dock_->findActiveItem(item->left() + item->getWidth(), y), i);
+  }
+  QCOMPARE(dock_->findActiveItem(dock_->minWidth_, y), -1);
+}
+
+void DockPanelTest::coalesceMouseMoves() {
+  const int y = dock_->height() / 2;
+  QMouseEvent first(QEvent::MouseMove, QPointF(10, y), Qt::NoButton,
+                    Qt::NoButton, Qt::NoModifier);
+  QMouseEvent second(QEvent::MouseMove, QPointF(20, y), Qt::NoButton,
+                     Qt::NoButton, Qt::NoModifier);
+  QMouseEvent third(QEvent::MouseMove, QPointF(30, y), Qt::NoButton,
+                    Qt::NoButton, Qt::NoModifier);
+
+  // The first move is laid out right away.
+  dock_->mouseMoveEvent(&first);
+  QCOMPARE(dock_->mouseX_, 10);
+
+  // The next ones in the same frame are coalesced.
+  dock_->mouseMoveEvent(&second);
+  dock_->mouseMoveEvent(&third);
+  QCOMPARE(dock_->mouseX_, 10);
+  QTRY_COMPARE(dock_->mouseX_, 30);
+  QVERIFY(!dock_->hasPendingMouseMove_);
+}
+
+void DockPanelTest::fixedSizeWindow() {
+  model_->setFixedSizeWindow(true);
+  dock_->reload();
+  QCOMPARE(dock_->size(), QSize(dock_->maxWidth_, dock_->maxHeight_));
+  QCOMPARE(dock_->mask().boundingRect(),
+           QRect(dock_->minimizedOffset(),
+                 QSize(dock_->minWidth_, dock_->minHeight_)));
+
+  const QPoint position = dock_->pos();
+  dock_->updateLayout(dock_->maxWidth_ / 2, dock_->maxHeight_ / 2);
+  QCOMPARE(dock_->pos(), position);
+  QCOMPARE(dock_->mask().boundingRect(), dock_->rect());
+
+  dock_->updateLayout();
+  QCOMPARE(dock_->pos(), position);
+  QCOMPARE(dock_->size(), QSize(dock_->maxWidth_, dock_->maxHeight_));
+}
+
+void DockPanelTest::iconAtlas() {
+  dock_->updateLayout();
+  QVERIFY(dock_->updateIconAtlas());
+  // The slots are apart, so that no neighbouring icon is blended in.
+  for (int i = 1; i < dock_->itemCount(); ++i) {
+    QVERIFY(!dock_->iconAtlasSlot(i).intersects(
+        dock_->iconAtlasSlot(i - 1).adjusted(-1, -1, 1, 1)));
+  }
+  drawIcons();
+  QVERIFY(!isIconAtlasCurrent());
+  drawIcons();
+  QVERIFY(isIconAtlasCurrent());
+
+  // Zooming changes the icons of the zoomed items.
+  dock_->updateLayout(dock_->maxWidth_ / 2, dock_->maxHeight_ / 2);
+  drawIcons();
+  drawIcons();
+  QVERIFY(isIconAtlasCurrent());
+}
+
+void DockPanelTest::reloadTasks() {
+  std::vector<const DockItem*> items;
+  for (const auto& item : dock_->items_) {
+    items.push_back(item.get());
+  }
+  dock_->reloadTasks();
+  QCOMPARE(dock_->itemCount(), static_cast<int>(items.size()));
+  for (int i = 0; i < dock_->itemCount(); ++i) {
+    QCOMPARE(dock_->items_[i].get(), items[i]);
+  }
+}
+
+void DockPanelTest::updateTasks() {
+  dock_->updateTasks({});
+  std::vector<const DockItem*> items;
+  for (const auto& item : dock_->items_) {
+    items.push_back(item.get());
+  }
+  const int itemCount = dock_->itemCount();
+  const auto programCount = [this](const QString& taskCommand) {
+    return static_cast<int>(std::count_if(
+        dock_->items_.begin(), dock_->items_.end(),
+        [&taskCommand](const std::unique_ptr<DockItem>& item) {
+          return item->getTaskCommand() == taskCommand;
+        }));
+  };
+  const TaskInfo foo1(1, "Foo", "foo", "Foo 1", QPixmap(), false);
+  const TaskInfo foo2(2, "Foo", "foo", "Foo 2", QPixmap(), false);
+  const TaskInfo bar(3, "Bar", "bar", "Bar", QPixmap(), false);
+
+  dock_->updateTasks({foo1, foo2, bar});
+  QCOMPARE(dock_->itemCount(), itemCount + 2);
+  QCOMPARE(programCount("foo"), 1);
+  QCOMPARE(programCount("bar"), 1);
+  QCOMPARE(dock_->taskItems_.size(), size_t{3});
+
+  // The remaining tasks are not added again.
+  dock_->updateTasks({foo1, bar});
+  QCOMPARE(dock_->itemCount(), itemCount + 2);
+  QCOMPARE(dock_->taskItems_.size(), size_t{2});
+  QVERIFY(dock_->taskItems_.at(1)->hasTask(1));
+  QVERIFY(!dock_->taskItems_.at(1)->hasTask(2));
+
+  // The unpinned program without tasks is removed.
+  dock_->updateTasks({bar});
+  QCOMPARE(dock_->itemCount(), itemCount + 1);
+  QCOMPARE(programCount("foo"), 0);
+  QCOMPARE(programCount("bar"), 1);
+
+  // The launchers and the clock are kept.
+  dock_->updateTasks({});
+  QCOMPARE(dock_->itemCount(), itemCount);
+  for (int i = 0; i < itemCount; ++i) {
+    QCOMPARE(dock_->items_[i].get(), items[i]);
+  }
+}
+
+void DockPanelTest::taskCommandAlias() {
+  setLaunchers({LauncherConfig("System Settings", "preferences-system",
+                               QIcon(), "systemsettings5")});
+  const int itemCount = dock_->itemCount();
+  const int launcher =
+      dock_->applicationMenuItemCount() + dock_->pagerItemCount();
+  QCOMPARE(dock_->items_[launcher]->getTaskCommand(),
+           QString("systemsettings5"));
+
+  dock_->updateTasks({TaskInfo(1, "System Settings", "systemsettings",
+                               "System Settings", QPixmap(), false)});
+  QCOMPARE(dock_->itemCount(), itemCount);
+  QCOMPARE(dock_->taskItems_.at(1), dock_->items_[launcher].get());
+  QVERIFY(dock_->items_[launcher]->hasTask(1));
+}
+
+void DockPanelTest::newProgramPosition() {
+  setLaunchers({LauncherConfig("A", "a", QIcon(), "a"),
+                LauncherConfig("Z", "z", QIcon(), "z"),
+                LauncherConfig("Separator", "xorg", QIcon(), "SEPARATOR")});
+  const int first =
+      dock_->applicationMenuItemCount() + dock_->pagerItemCount();
+  QCOMPARE(dock_->items_[first]->getTaskCommand(), QString("a"));
+  QCOMPARE(dock_->items_[first + 1]->getTaskCommand(), QString("z"));
+  const int itemCount = dock_->itemCount();
+
+  // Sorted among the launchers.
+  const int i = dock_->findTaskCommandInsertionIndex("m");
+  QCOMPARE(i, first + 1);
+  dock_->updateTasks({TaskInfo(1, "M", "m", "M", QPixmap(), false)});
+  QCOMPARE(dock_->itemCount(), itemCount + 1);
+  auto* program = dynamic_cast<Program*>(dock_->items_[i].get());
+  QVERIFY(program != nullptr);
+  QCOMPARE(program->getTaskCommand(), QString("m"));
+  QVERIFY(!program->pinned());
+  QVERIFY(program->hasTask(1));
+  QCOMPARE(dock_->items_[i + 1]->getTaskCommand(), QString("z"));
+
+  // Before the separator if it sorts after all the launchers.
+  QCOMPARE(dock_->findTaskCommandInsertionIndex("zz"), first + 3);
+  QVERIFY(dock_->items_[first + 3]->getTaskCommand().isEmpty());
+}
+
+void DockPanelTest::removeProgramTaskCommands() {
+  setLaunchers({});
+  const int itemCount = dock_->itemCount();
+  const TaskInfo task(1, "System Settings", "systemsettings5",
+                      "System Settings", QPixmap(), false);
+
+  dock_->updateTasks({task});
+  QCOMPARE(dock_->itemCount(), itemCount + 1);
+  QVERIFY(dock_->taskCommandItems_.contains("systemsettings5"));
+  QVERIFY(dock_->taskCommandItems_.contains("systemsettings"));
+
+  dock_->updateTasks({});
+  QCOMPARE(dock_->itemCount(), itemCount);
+  QVERIFY(!dock_->taskCommandItems_.contains("systemsettings5"));
+  QVERIFY(!dock_->taskCommandItems_.contains("systemsettings"));
+  QVERIFY(dock_->taskCommandItems_.isEmpty());
+}
+
 }  // namespace ksmoothdock
 
 QTEST_MAIN(ksmoothdock::DockPanelTest)
@@ -27,7 +27,6 @@
 #include <Qt>
 
 #include <KDesktopFile>
-#include <KIconLoader>
 #include <KLocalizedString>
 
 #include "program.h"
@@ -297,10 +296,8 @@ void EditLaunchersDialog::resetCommandLists() {
 void EditLaunchersDialog::loadData() {
   launchers_->clear();
   for (const auto& item : model_->dockLauncherConfigs(dockId_)) {
-    QPixmap icon = KIconLoader::global()->loadIcon(
-        item.icon, KIconLoader::NoGroup, kListIconSize);
     QListWidgetItem* listItem = new QListWidgetItem(
-          icon, item.name);
+          getListItemIcon(item.icon), item.name);
     listItem->setData(Qt::UserRole, QVariant::fromValue(
                         LauncherInfo(item.icon, item.command)));
     launchers_->addItem(listItem);
@@ -30,9 +30,9 @@
 #include <QMetaType>
 
 #include <KIconButton>
-#include <KIconLoader>
 
 #include <model/multi_dock_model.h>
+#include <utils/icon_cache.h>
 
 namespace Ui {
   class EditLaunchersDialog;
@@ -110,8 +110,7 @@ class EditLaunchersDialog : public QDialog {
   void saveData();
 
   QIcon getListItemIcon(const QString& iconName) {
-    return QIcon(KIconLoader::global()->loadIcon(iconName,
-        KIconLoader::NoGroup, kListIconSize));
+    return QIcon(IconCache::global()->loadIcon(iconName, kListIconSize));
   }
 
   void populateInternalCommands();
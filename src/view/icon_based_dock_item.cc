@@ -18,14 +18,21 @@
 
 #include "icon_based_dock_item.h"
 
-#include <KIconLoader>
+#include <algorithm>
+#include <cmath>
 
+#include <QGuiApplication>
 #include <QImage>
 #include <qicon.h>
 
+#include <utils/icon_cache.h>
+
+#include "dock_panel.h"
+
 namespace ksmoothdock {
 
 const int IconBasedDockItem::kIconLoadSize;
+constexpr float IconBasedDockItem::kIconLevelRatio;
 
 IconBasedDockItem::IconBasedDockItem(DockPanel* parent, const QString& label, Qt::Orientation orientation,
                   const QString& iconName, int minSize, int maxSize)
@@ -40,8 +47,9 @@ IconBasedDockItem::IconBasedDockItem(DockPanel* parent, const QString& label,
   setIcon(icon);
 }
 
-void IconBasedDockItem::draw(QPainter* painter) const {
-    icon.paint(painter, left_, top_, size_, size_);
+const QPixmap* IconBasedDockItem::getCurrentIcon() const {
+  const QPixmap& scaledIcon = getIcon(size());
+  return scaledIcon.isNull() ? nullptr : &scaledIcon;
 }
 
 void IconBasedDockItem::setIcon(const QPixmap& pixmap) {
@@ -51,18 +59,50 @@ void IconBasedDockItem::setIcon(const QPixmap& pixmap) {
 void IconBasedDockItem::setIconName(const QString& iconName) {
   if (!iconName.isEmpty()) {
     iconName_ = iconName;
-    QPixmap pixmap = KIconLoader::global()->loadIcon(iconName,
-        KIconLoader::NoGroup, kIconLoadSize);
-    setIcon(pixmap);
+    setIcon(IconCache::global()->loadIcon(iconName, kIconLoadSize));
   }
 }
 
-const QIcon& IconBasedDockItem::getIcon(int size) const {
+const QPixmap& IconBasedDockItem::getIcon(int size) const {
+  if (iconLevels_.empty()) {  // no icon set yet.
+    return icon_;
+  }
+
+  size = std::min(std::max(size, minSize_), maxSize_);
+  const int level = std::min(
+      static_cast<int>(std::lower_bound(iconLevelSizes_.begin(),
+                                        iconLevelSizes_.end(), size)
+                       - iconLevelSizes_.begin()),
+      static_cast<int>(iconLevelSizes_.size()) - 1);
+  QPixmap& icon = iconLevels_[level];
+  // The levels are rendered for the screen that the dock is on, which can
+  // have a lower device pixel ratio than the application's highest one.
+  const qreal devicePixelRatio = (parent_ != nullptr)
+      ? parent_->devicePixelRatioF() : qApp->devicePixelRatio();
+  if (!icon_.isNull() && (icon.isNull()
+      || icon.devicePixelRatioF() != devicePixelRatio)) {
+    const int levelSize = iconLevelSizes_[level];
+    QImage image = icon_.toImage().scaled(
+        std::lround(getWidthForSize(levelSize) * devicePixelRatio),
+        std::lround(getHeightForSize(levelSize) * devicePixelRatio),
+        Qt::KeepAspectRatio, Qt::SmoothTransformation)
+        .convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    image.setDevicePixelRatio(devicePixelRatio);
+    icon = QPixmap::fromImage(image);
+  }
   return icon;
 }
 
 void IconBasedDockItem::generateIcons(const QPixmap& pixmap) {
-    icon = QIcon(pixmap);
+  icon_ = pixmap;
+  originalImage = pixmap.toImage();
+  iconLevelSizes_.clear();
+  for (int size = minSize_; size < maxSize_;
+       size = std::max(static_cast<int>(size * kIconLevelRatio), size + 1)) {
+    iconLevelSizes_.push_back(size);
+  }
+  iconLevelSizes_.push_back(std::max(maxSize_, minSize_));
+  iconLevels_.assign(iconLevelSizes_.size(), QPixmap());
 }
 
 }  // namespace ksmoothdock
@@ -42,32 +42,48 @@ class IconBasedDockItem : public DockItem {
   virtual ~IconBasedDockItem() {}
 
   int getWidthForSize(int size) const override {
-    return size_;
+    return size;
   }
 
   int getHeightForSize(int size) const override {
-      return size_;
+    return size;
   }
 
-  void draw(QPainter* painter) const override;
+  const QPixmap* getCurrentIcon() const override;
 
   // Sets the icon on the fly.
   void setIcon(const QPixmap& icon);
   void setIconName(const QString& iconName);
-  const QIcon& getIcon(int size) const;
+  // Gets the icon for the given item size, which is clamped to
+  // [minSize_, maxSize_]. This is the smallest icon level that is at least
+  // this size, so it needs scaling down to fit the item unless the size is
+  // one of the levels.
+  const QPixmap& getIcon(int size) const;
   QString getIconName() const { return iconName_; }
 
  protected:
-  QIcon icon;
+  // The icon as loaded.
+  QPixmap icon_;
 
   QString iconName_;
   QImage originalImage;
 
  private:
   static const int kIconLoadSize = 128;
+  // The size ratio between two consecutive icon levels.
+  static constexpr float kIconLevelRatio = 1.125;
 
   void generateIcons(const QPixmap& icon);
 
+  // The item sizes of the icon levels, from minSize_ to maxSize_.
+  std::vector<int> iconLevelSizes_;
+
+  // Icons pre-scaled for the levels, at the device pixel ratio of the dock's
+  // screen and in the premultiplied ARGB format. They are generated lazily as
+  // they are drawn, and again if the dock moves to a screen with a different
+  // device pixel ratio.
+  mutable std::vector<QPixmap> iconLevels_;
+
   friend class DockPanel;
 };
 
@@ -18,9 +18,12 @@
 
 #include "multi_dock_view.h"
 
+#include <QGuiApplication>
+
 #include <KWindowSystem>
 
 #include "add_panel_dialog.h"
+#include <utils/font_utils.h>
 
 namespace ksmoothdock {
 
@@ -32,6 +35,12 @@ MultiDockView::MultiDockView(MultiDockModel* model)
           SLOT(setPlasmaWallpaper(int)));
   connect(KWindowSystem::self(), SIGNAL(currentDesktopChanged(int)),
           &wallpaperHelper_, SLOT(setPlasmaWallpapers()));
+  // Connected before the docks are created so that the cached fonts are
+  // cleared before the docks repaint or reload.
+  connect(model_, &MultiDockModel::appearanceOutdated, clearFontSizeCache);
+  connect(model_, &MultiDockModel::appearanceChanged, clearFontSizeCache);
+  connect(qApp, &QGuiApplication::fontDatabaseChanged, clearFontSizeCache);
+  connect(qApp, &QGuiApplication::fontChanged, clearFontSizeCache);
   loadData();
 }
 
@@ -26,6 +26,7 @@
 
 #include "dock_panel.h"
 #include <model/multi_dock_model.h>
+#include <utils/task_helper.h>
 #include <utils/wallpaper_helper.h>
 
 namespace ksmoothdock {
@@ -41,6 +42,9 @@ class MultiDockView : public QObject {
 
   void show();
 
+  // The task helper shared by all the docks.
+  TaskHelper* taskHelper() { return &taskHelper_; }
+
  public slots:
   void exit();
 
@@ -53,6 +57,8 @@ class MultiDockView : public QObject {
   void createDefaultDock();
 
   MultiDockModel* model_;  // No ownership.
+  // Declared before the docks so that it outlives them.
+  TaskHelper taskHelper_;
   std::unordered_map<int, std::unique_ptr<DockPanel>> docks_;
   WallpaperHelper wallpaperHelper_;
 };
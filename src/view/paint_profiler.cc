@@ -0,0 +1,131 @@
+/*
+ * This file is part of KSmoothDock.
+ * Copyright (C) 2018 Viet Dang (dangvd@gmail.com)
+ *
+ * KSmoothDock is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * KSmoothDock is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with KSmoothDock.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "paint_profiler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cxxabi.h>
+#include <utility>
+
+#include <QtGlobal>
+
+namespace ksmoothdock {
+
+namespace {
+
+// Gets the readable name of a stage, which may be a mangled class name.
+QString stageName(const char* stage) {
+  int status = 0;
+  char* demangled = abi::__cxa_demangle(stage, nullptr, nullptr, &status);
+  if (demangled == nullptr) {
+    return QString::fromUtf8(stage);
+  }
+  QString name = QString::fromUtf8(demangled);
+  std::free(demangled);
+  return name.remove("ksmoothdock::") + "::draw";
+}
+
+// Gets the value at the given percentile of the sorted values, in
+// microseconds.
+double percentile(const std::vector<qint64>& sorted, double p) {
+  const int rank = static_cast<int>(std::ceil(p / 100 * sorted.size()));
+  return sorted[std::max(rank, 1) - 1] / 1000.0;
+}
+
+}  // namespace
+
+constexpr int PaintProfiler::kNumFrames;
+constexpr char PaintProfiler::kLayout[];
+constexpr char PaintProfiler::kPaint[];
+constexpr char PaintProfiler::kBackground[];
+constexpr char PaintProfiler::kHighlights[];
+constexpr char PaintProfiler::kIcons[];
+constexpr char PaintProfiler::kFlush[];
+
+std::unique_ptr<PaintProfiler> PaintProfiler::createIfEnabled() {
+  return qEnvironmentVariableIsSet("KSMOOTHDOCK_PAINT_PROFILE")
+      ? std::make_unique<PaintProfiler>() : nullptr;
+}
+
+void PaintProfiler::addTime(const char* stage, qint64 nanos) {
+  Stage& s = getStage(stage);
+  s.current += nanos;
+  s.isInCurrentFrame = true;
+}
+
+void PaintProfiler::endFrame(qint64 updateNanos) {
+  addTime(kFlush, updateNanos - getStage(kPaint).current);
+  for (Stage& stage : stages_) {
+    if (!stage.isInCurrentFrame) {
+      continue;
+    }
+    if (static_cast<int>(stage.frames.size()) < kNumFrames) {
+      stage.frames.push_back(stage.current);
+    } else {
+      stage.frames[stage.next] = stage.current;
+    }
+    stage.next = (stage.next + 1) % kNumFrames;
+    stage.current = 0;
+    stage.isInCurrentFrame = false;
+  }
+  ++numFrames_;
+}
+
+QString PaintProfiler::report() const {
+  QString report = QString("%1 frames, the last %2 kept per stage, in us\n")
+      .arg(numFrames_).arg(kNumFrames);
+  report += QString("%1 %2 %3 %4 %5\n").arg("stage", -32).arg("frames", 8)
+      .arg("p50", 10).arg("p95", 10).arg("p99", 10);
+  std::vector<std::pair<QString, const Stage*>> stages;
+  for (const Stage& stage : stages_) {
+    if (!stage.frames.empty()) {
+      stages.emplace_back(stageName(stage.name), &stage);
+    }
+  }
+  std::sort(stages.begin(), stages.end(),
+            [](const std::pair<QString, const Stage*>& a,
+               const std::pair<QString, const Stage*>& b) {
+              return a.first < b.first;
+            });
+  for (const auto& entry : stages) {
+    std::vector<qint64> frames = entry.second->frames;
+    std::sort(frames.begin(), frames.end());
+    report += QString("%1 %2 %3 %4 %5\n")
+        .arg(entry.first, -32)
+        .arg(static_cast<int>(frames.size()), 8)
+        .arg(percentile(frames, 50), 10, 'f', 1)
+        .arg(percentile(frames, 95), 10, 'f', 1)
+        .arg(percentile(frames, 99), 10, 'f', 1);
+  }
+  return report;
+}
+
+PaintProfiler::Stage& PaintProfiler::getStage(const char* name) {
+  for (Stage& stage : stages_) {
+    if (stage.name == name) {
+      return stage;
+    }
+  }
+  stages_.push_back(Stage());
+  stages_.back().name = name;
+  return stages_.back();
+}
+
+}  // namespace ksmoothdock
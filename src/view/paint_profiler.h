@@ -0,0 +1,112 @@
+/*
+ * This file is part of KSmoothDock.
+ * Copyright (C) 2018 Viet Dang (dangvd@gmail.com)
+ *
+ * KSmoothDock is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * KSmoothDock is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with KSmoothDock.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KSMOOTHDOCK_PAINT_PROFILER_H_
+#define KSMOOTHDOCK_PAINT_PROFILER_H_
+
+#include <memory>
+#include <vector>
+
+#include <QElapsedTimer>
+#include <QString>
+
+namespace ksmoothdock {
+
+// Records the time spent in each stage of the frames of a dock panel, e.g.
+// layout, background, each dock item class's draw() and flush, and reports
+// their percentiles.
+//
+// Profiling is opt-in: it's enabled by setting the environment variable
+// KSMOOTHDOCK_PAINT_PROFILE, and costs a null check per stage otherwise.
+class PaintProfiler {
+ public:
+  // The number of frames kept per stage. Older frames are overwritten.
+  static constexpr int kNumFrames = 1024;
+
+  // The stage names.
+  static constexpr char kLayout[] = "layout";
+  static constexpr char kPaint[] = "paint";
+  static constexpr char kBackground[] = "background";
+  static constexpr char kHighlights[] = "highlights";
+  static constexpr char kIcons[] = "icons";
+  static constexpr char kFlush[] = "flush";
+
+  // Creates a profiler if profiling is enabled, otherwise returns nullptr.
+  static std::unique_ptr<PaintProfiler> createIfEnabled();
+
+  // Adds time to the stage in the current frame. The stage is one of the
+  // stage names above or a class's typeid().name(), which are identified by
+  // their address.
+  void addTime(const char* stage, qint64 nanos);
+
+  // Ends the current frame, given the time of the whole update, i.e. painting
+  // and flushing. The flush time is the part not spent in paintEvent().
+  //
+  // Stages that happen before the update, such as layout, are counted in the
+  // frame that they are painted in.
+  void endFrame(qint64 updateNanos);
+
+  // Returns the report of the recorded frames: the 50th, 95th and 99th
+  // percentiles of each stage, in microseconds.
+  QString report() const;
+
+ private:
+  // The times of a stage in the last kNumFrames frames that had this stage.
+  struct Stage {
+    const char* name = nullptr;
+    std::vector<qint64> frames;
+    int next = 0;
+    qint64 current = 0;
+    bool isInCurrentFrame = false;
+  };
+
+  // Gets the stage with the given name, added if it's not there yet.
+  Stage& getStage(const char* name);
+
+  // There are a few stages per item class, so they are looked up by a linear
+  // scan that only compares the addresses of their names.
+  std::vector<Stage> stages_;
+  int numFrames_ = 0;
+};
+
+// Adds the time from its construction to its destruction to a stage of the
+// profiler, if any.
+class PaintTimer {
+ public:
+  PaintTimer(PaintProfiler* profiler, const char* stage)
+      : profiler_(profiler), stage_(stage) {
+    if (profiler_ != nullptr) {
+      timer_.start();
+    }
+  }
+
+  ~PaintTimer() {
+    if (profiler_ != nullptr) {
+      profiler_->addTime(stage_, timer_.nsecsElapsed());
+    }
+  }
+
+ private:
+  PaintProfiler* profiler_;
+  const char* stage_;
+  QElapsedTimer timer_;
+};
+
+}  // namespace ksmoothdock
+
+#endif  // KSMOOTHDOCK_PAINT_PROFILER_H_
@@ -75,15 +75,14 @@ Program::Program(DockPanel* parent, MultiDockModel* model, const QString& label,
 }
 
 
-void Program::draw(QPainter *painter) const {
+void Program::drawHighlight(QPainter *painter) const {
   if ((!tasks_.empty() && active()) || attentionStrong_) {
-    drawHighlightedIcon(QColor::fromRgb(0,0,0, 210) , left_, top_, getWidth(), getHeight(),
-                        5, size_ / 8, painter);
+    drawHighlightedIcon(QColor::fromRgb(0,0,0, 210) , left(), top(), getWidth(), getHeight(),
+                        5, size() / 8, painter);
   } else if (!tasks_.empty()) {
-    drawHighlightedIcon(QColor::fromRgb(0,0,0, 210), left_, top_, getWidth(), getHeight(),
-                        5, size_ / 8, painter, 0.25);
+    drawHighlightedIcon(QColor::fromRgb(0,0,0, 210), left(), top(), getWidth(), getHeight(),
+                        5, size() / 8, painter, 0.25);
   }
-  IconBasedDockItem::draw(painter);
 }
 
 void Program::mousePressEvent(QMouseEvent* e) {
@@ -192,10 +191,6 @@ bool Program::hasTask(WId wId) {
   return false;
 }
 
-bool Program::beforeTask(const QString& command) {
-  return taskCommand_ < command;
-}
-
 void Program::launch() {
   launch(command_);
   parent_->showWaitCursor();
@@ -205,7 +200,7 @@ void Program::launch() {
 void Program::pinUnpin() {
   pinned_ = !pinned_;
   if (pinned_) {
-    model_->addLauncher(parent_->dockId(), LauncherConfig(label_, iconName_, icon, command_));
+    model_->addLauncher(parent_->dockId(), LauncherConfig(label_, iconName_, QIcon(icon_), command_));
   } else {  // !pinned
     model_->removeLauncher(parent_->dockId(), command_);
     if (shouldBeRemoved()) {
@@ -58,7 +58,7 @@ class Program : public QObject, public IconBasedDockItem {
 
   ~Program() override = default;
 
-  void draw(QPainter* painter) const override;
+  void drawHighlight(QPainter* painter) const override;
 
   void mousePressEvent(QMouseEvent* e) override;
 
@@ -72,7 +72,7 @@ class Program : public QObject, public IconBasedDockItem {
 
   bool hasTask(WId wId) override;
 
-  bool beforeTask(const QString& command) override;
+  QString getTaskCommand() const override { return taskCommand_; }
 
   bool shouldBeRemoved() override { return taskCount() == 0 && !pinned_; }
 
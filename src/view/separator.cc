@@ -33,17 +33,17 @@ Separator::Separator(DockPanel* parent, MultiDockModel* model, Qt::Orientation o
 void Separator::draw(QPainter* painter) const {
   int x, y, w, h;
   if (orientation_ == Qt::Horizontal) {
-    x = left_ + getWidth() / 2;
+    x = left() + getWidth() / 2;
     y = (parent_->position() == PanelPosition::Top)
-        ? top_
-        : getHeight() - getMinHeight() + top_;
+        ? top()
+        : getHeight() - getMinHeight() + top();
     w = 1;
     h = getMinHeight();
   } else {  // Vertical.
     x = (parent_->position() == PanelPosition::Left)
-        ? left_
-        : getWidth() - getMinWidth() + left_;
-    y = top_ + getHeight() / 2;
+        ? left()
+        : getWidth() - getMinWidth() + left();
+    y = top() + getHeight() / 2;
     w = getMinWidth();
     h = 1;
   }
@@ -38,8 +38,6 @@ class Separator : public QObject, public IconlessDockItem {
 
   void mousePressEvent(QMouseEvent* e) override { /* no-op */ }
 
-  bool beforeTask(const QString& command) override { return false; }
-
  private:
   static constexpr float kWhRatio = 0.1;
 